@@ -3,9 +3,17 @@
 #include <Arduino.h>
 #include <FastLED.h>
 #include "config.h"
+#include "rng.h"
+#include <new>
 
-// Maximum number of animations that can be registered
-#define MAX_ANIMATIONS 16
+// Maximum number of animations, built-in ones and effect files together.
+// The build fails if animation_list.h names more than this.
+#define MAX_ANIMATIONS 20
+
+// Arena slot each running animation is constructed in. REGISTER_ANIMATION
+// fails to compile for any animation that does not fit.
+#define ANIMATION_SLOT_SIZE  (3 * MAX_NUM_LEDS + 64)
+#define ANIMATION_SLOT_ALIGN 8
 
 // ======================================================
 // Animation Base Class
@@ -18,38 +26,111 @@ public:
     // Called once when animation starts
     virtual void reset() {}
 
-    // Called repeatedly to update the animation
-    // Should return quickly (non-blocking)
-    virtual void update(CRGB* leds, uint8_t numLeds) = 0;
+    // Target time between frames; the manager calls update() at this rate
+    virtual uint16_t frameIntervalMs() const { return 20; }
+
+    // Called once per frame to render the animation into leds
+    // Should return quickly (non-blocking); returns true if the frame changed.
+    // The manager sends the frame, animations never touch the output.
+    virtual bool update(CRGB* leds, uint16_t numLeds) = 0;
 
     const char* getName() const { return _name; }
 
+    // Animation clock, set before reset() and update() are called. The
+    // manager drives it from millis(); the benchmark steps it directly.
+    static void setTime(uint32_t ms) { _timeMs = ms; }
+
+    // Strip length, set before reset() so animations can place themselves.
+    // update() is always called with this many LEDs.
+    static void setLength(uint16_t numLeds) { _length = numLeds; }
+
+    // Random stream, seeded by the manager when the animation is loaded so a
+    // given master seed always renders the same frames
+    void seed(const Rng& rng) { _rng = rng; }
+
+protected:
+    static uint32_t timeMs() { return _timeMs; }
+    static uint16_t stripLength() { return _length; }
+    Rng& rng() { return _rng; }
+
 private:
     const char* _name;
+    Rng _rng;
+    static uint32_t _timeMs;
+    static uint16_t _length;
+};
+
+// ======================================================
+// Animation Registry Entry
+// ======================================================
+// What REGISTER_ANIMATION records instead of a live instance: animations
+// are only constructed while they run.
+struct AnimationEntry {
+    const char* name;
+    uint16_t size;                    // sizeof the animation class
+    Animation* (*create)(void* mem, const void* context);  // Placement-constructs it in mem
+    const void* context;              // Handed to create (an effect program), or nullptr
+};
+
+// Entry of animation class T, defined by REGISTER_ANIMATION in T's own file
+template<typename T>
+struct AnimationInfo {
+    static const AnimationEntry entry;
+};
+
+// A fixed list of animation classes and a table of their entries. The
+// table is a constant built by the compiler, so nothing runs at boot to
+// fill it and the order is the order of the list.
+template<typename... Animations>
+struct AnimationList {
+    static constexpr uint8_t count = sizeof...(Animations);
+    static constexpr const AnimationEntry* entries[] = {&AnimationInfo<Animations>::entry...};
 };
 
 // ======================================================
 // Animation Manager (Singleton)
 // ======================================================
+// The built-in animations come from animation_list.h; only effect programs
+// loaded at boot are registered at runtime. The instance is a constant-
+// initialized static, so getInstance() needs no first-call guard.
 class AnimationManager {
 public:
-    static AnimationManager& getInstance();
+    static AnimationManager& getInstance() { return _instance; }
+
+    // Add an animation after the built-in ones, before the game task starts
+    // Returns false if MAX_ANIMATIONS are already registered
+    bool registerAnimation(const AnimationEntry* entry);
+
+    // Get animation count, built-in and registered
+    uint8_t getCount() const;
+
+    // Get animation name by index
+    const char* getName(uint8_t index) const;
 
-    // Register an animation (called automatically by Animation constructor)
-    void registerAnimation(Animation* animation);
+    // Size of the largest registered animation (fits ANIMATION_SLOT_SIZE)
+    uint16_t largestSize() const;
 
-    // Get animation count
-    uint8_t getCount() const { return _count; }
+    // Construct animation `index` in arena slot 0 or 1, destroying whatever
+    // was there. The manager uses both slots while cross-fading.
+    Animation* load(uint8_t slot, uint8_t index);
 
-    // Get animation by index
-    Animation* getAnimation(uint8_t index) const;
+    // Destroy all running animations; update() restarts from scratch
+    void unload();
 
-    // Run the current animation, auto-switch after duration
-    void update(CRGB* leds, uint8_t numLeds);
+    // Run the current animation, auto-switch after duration, and send the
+    // frame if it changed. Returns true if a frame was sent. A change of
+    // numLeds restarts the current animation at the new length.
+    bool update(CRGB* leds, uint16_t numLeds);
 
-    // Force switch to next animation
+    // Time until update() next has work to do (frame, blend step or switch)
+    uint32_t msUntilNextFrame() const;
+
+    // Cross-fade to the next animation
     void next();
 
+    // Slowest cross-fade frame (both renders plus blend) of the last fade
+    uint32_t lastFadeWorstUs() const { return _fadeWorstUs; }
+
     // Reset to first animation
     void resetToFirst();
 
@@ -59,12 +140,42 @@ public:
     void interrupt() { _interrupted = true; }
 
 private:
-    AnimationManager() : _count(0), _currentIndex(0), _startTime(0), _interrupted(false) {}
-
-    Animation* _animations[MAX_ANIMATIONS];
-    uint8_t _count;
+    // A running animation and the frame it renders into. Each animation
+    // keeps its own frame so effects that build on the previous frame see
+    // their own output, never another animation's.
+    struct Slot {
+        alignas(ANIMATION_SLOT_ALIGN) uint8_t storage[ANIMATION_SLOT_SIZE];
+        Animation* anim;
+        uint32_t nextFrameMs;
+        CRGB frame[MAX_NUM_LEDS];
+    };
+
+    constexpr AnimationManager() : _added{}, _addedCount(0), _currentIndex(0), _startTime(0), _numLeds(0),
+                                   _slots{}, _active(0), _fading(false), _fadeStartMs(0), _nextBlendMs(0),
+                                   _fadeWorstUs(0), _interrupted(false) {}
+
+    static AnimationManager _instance;
+
+    const AnimationEntry* entry(uint8_t index) const;
+    void start(uint8_t index, uint32_t now);
+    void unloadSlot(uint8_t slot);
+    bool renderSlot(Slot& slot, uint16_t numLeds, uint32_t now);
+    bool updateFade(CRGB* leds, uint16_t numLeds, uint32_t now, uint32_t startUs, bool changed);
+
+    const AnimationEntry* _added[MAX_ANIMATIONS];
+    uint8_t _addedCount;
     uint8_t _currentIndex;
     uint32_t _startTime;
+    uint16_t _numLeds;
+
+    // Incoming/current animation in _slots[_active], outgoing in the other
+    Slot _slots[2];
+    uint8_t _active;
+    bool _fading;
+    uint32_t _fadeStartMs;
+    uint32_t _nextBlendMs;
+    uint32_t _fadeWorstUs;
+
     bool _interrupted;
 };
 
@@ -72,5 +183,13 @@ private:
 // Macro for easy animation registration
 // ======================================================
 // Usage: REGISTER_ANIMATION(MyAnimation, "My Animation Name")
+// Defines the class's entry as a constant. The animation only joins the
+// rotation once it is also listed in animation_list.h.
 #define REGISTER_ANIMATION(ClassName, Name) \
-    static ClassName _instance_##ClassName(Name)
+    static_assert(sizeof(ClassName) <= ANIMATION_SLOT_SIZE, \
+                  #ClassName " does not fit ANIMATION_SLOT_SIZE"); \
+    static_assert(alignof(ClassName) <= ANIMATION_SLOT_ALIGN, \
+                  #ClassName " needs more than ANIMATION_SLOT_ALIGN"); \
+    static Animation* _create_##ClassName(void* mem, const void*) { return new (mem) ClassName(Name); } \
+    template<> const AnimationEntry AnimationInfo<ClassName>::entry = \
+        {Name, sizeof(ClassName), _create_##ClassName, nullptr}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "effect_library.h"
+
+// ======================================================
+// Animation Benchmark
+// ======================================================
+// Times every registered animation frame by frame. Each animation is reset
+// and updated BENCH_FRAMES times per strip length, with the animation clock
+// stepped by its own frame interval as the manager would. CPU time comes from
+// the cycle counter on the board and a monotonic clock on the host. Only
+// the render is timed: animations never touch the LED output.
+//
+// The per-frame kernels (see FrameKernels) are timed at the same lengths,
+// the blend both through its fixed-length dispatch and the runtime-length
+// fallback.
+//
+// Each built-in effect program is timed against the native animation it
+// re-creates and must render the same frames at no more than
+// BENCH_EFFECT_MAX_RATIO times its cost.
+//
+// Results are printed as one JSON object per line:
+//   {"bench":"frame","anim":"Fire","leds":55,"frames":200,"drawn":200,"mean_us":41.20,"p99_us":52.80,"max_us":57.10,"budget_us":1000,"pass":true}
+//   {"bench":"kernel","leds":150,"specialised":true,"encode_us":1.62,"blend_us":1.41,"blend_generic_us":1.85}
+//   {"bench":"effect","anim":"Cylon","leds":150,"frames":200,"native_us":0.35,"program_us":0.52,"ratio":1.49,"max_ratio":2.00,"same_frames":true,"pass":true}
+//   {"bench":"summary","runs":52,"failures":0,"pass":true}
+//
+// Run it from attract mode only: it borrows the manager's animation arena.
+class AnimationBench {
+public:
+    // Returns false if any animation's 99th percentile frame exceeded
+    // BENCH_FRAME_BUDGET_US, or an effect program failed
+    static bool run(Print& out);
+
+    // Failed runs of every run() so far; the native build exits non-zero
+    // if there were any
+    static uint16_t failures() { return _failures; }
+
+private:
+    static bool runOne(Print& out, uint8_t index, uint16_t numLeds);
+    static void runKernels(Print& out, uint16_t numLeds);
+    static bool runEffect(Print& out, const EffectSource& source, uint16_t numLeds);
+
+    static uint16_t _failures;
+};
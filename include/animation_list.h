@@ -0,0 +1,45 @@
+#pragma once
+
+#include "animation.h"
+
+// ======================================================
+// Built-in Animations
+// ======================================================
+// The attract rotation, in order. Each class is defined and registered with
+// REGISTER_ANIMATION in its own file under src/animations/; a new one is
+// declared here and added to BuiltinAnimations.
+#define DECLARE_ANIMATION(ClassName) \
+    class ClassName; \
+    template<> const AnimationEntry AnimationInfo<ClassName>::entry
+
+DECLARE_ANIMATION(RainbowDotAnimation);
+DECLARE_ANIMATION(PongDemoAnimation);
+DECLARE_ANIMATION(PlasmaCometAnimation);
+DECLARE_ANIMATION(CylonAnimation);
+DECLARE_ANIMATION(FireAnimation);
+DECLARE_ANIMATION(SparkleAnimation);
+DECLARE_ANIMATION(DuelChaseAnimation);
+DECLARE_ANIMATION(HeartbeatAnimation);
+DECLARE_ANIMATION(OceanWaveAnimation);
+DECLARE_ANIMATION(BouncingBallsAnimation);
+DECLARE_ANIMATION(MatrixRainAnimation);
+DECLARE_ANIMATION(LightningAnimation);
+DECLARE_ANIMATION(ColorBreathingAnimation);
+
+using BuiltinAnimations = AnimationList<
+    RainbowDotAnimation,
+    PongDemoAnimation,
+    PlasmaCometAnimation,
+    CylonAnimation,
+    FireAnimation,
+    SparkleAnimation,
+    DuelChaseAnimation,
+    HeartbeatAnimation,
+    OceanWaveAnimation,
+    BouncingBallsAnimation,
+    MatrixRainAnimation,
+    LightningAnimation,
+    ColorBreathingAnimation
+>;
+
+static_assert(BuiltinAnimations::count <= MAX_ANIMATIONS, "More built-in animations than MAX_ANIMATIONS");
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "game_types.h"
+#include "hit_judge.h"
+
+// Most balls in play at once
+#define MAX_BALLS 8
+
+// ======================================================
+// Ball Field
+// ======================================================
+// Every ball in play, kept as parallel arrays: ball i is index i in each
+// one, so a physics step walks four small contiguous arrays however many
+// balls there are. Positions and velocities are Q16.16 as in config.h; the
+// per-LED delay each velocity comes from is only touched on a return.
+// Removing a ball moves the last one into its place.
+class BallField {
+public:
+    BallField() : _count(0), _moved(false) {}
+
+    void clear() { _count = 0; _moved = true; }
+    uint8_t count() const { return _count; }
+
+    // Add a ball on the leading edge of LED pos, so its first step is due
+    // at once, moving one LED per delayMs; returns false if the field is full
+    bool add(int16_t pos, int8_t dir, uint16_t delayMs, uint32_t timeUs);
+    void remove(uint8_t ball);
+
+    // One physics step for every ball, recording LED changes at timeUs
+    // Returns true if any ball reached a new LED
+    bool step(uint32_t timeUs);
+
+    // Physics steps until the first ball reaches its next LED
+    uint32_t stepsUntilNextLed() const;
+
+    // Reverse a ball, mirroring it inside its LED so it spends a full LED
+    // of travel there before moving on
+    void bounce(uint8_t ball, int8_t dir, uint32_t timeUs);
+
+    // Send a ball back from LED pos with a full LED of travel ahead
+    void sendBack(uint8_t ball, int16_t pos, int8_t dir, uint32_t timeUs);
+
+    // Cut a ball's per-LED delay by cutMs, down to BALL_DELAY_MIN
+    void speedUp(uint8_t ball, uint16_t cutMs);
+
+    // The ball a press by player at pressUs returns: one that was in the
+    // player's zone, preferring balls heading into it, then the one
+    // closest to leaving. Returns -1 (hit untouched) if there is none.
+    int8_t judge(PlayerSide player, uint32_t pressUs, uint8_t zoneSize, uint16_t numLeds,
+                 HitJudgement& hit) const;
+
+    // A ball that has left the strip, or -1
+    int8_t findOut(uint16_t numLeds) const;
+
+    bool anyInZone(PlayerSide player, uint8_t zoneSize, uint16_t numLeds) const;
+
+    int16_t pos(uint8_t ball) const { return _pos[ball]; }
+    int8_t dir(uint8_t ball) const { return _dir[ball]; }
+
+    // True if any ball changed LED or direction since the last call
+    bool takeMoved() { bool moved = _moved; _moved = false; return moved; }
+
+private:
+    int32_t _posFx[MAX_BALLS];
+    int32_t _vel[MAX_BALLS];
+    int16_t _pos[MAX_BALLS];
+    int8_t  _dir[MAX_BALLS];
+    uint16_t _delayMs[MAX_BALLS];
+    BallHistory _history[MAX_BALLS];  // Only touched when a ball changes LED
+    uint8_t _count;
+    bool _moved;
+};
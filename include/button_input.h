@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "edge_debouncer.h"
+#include "game_types.h"
+#include "spsc_ring.h"
+
+// ======================================================
+// Button Input
+// ======================================================
+// GPIO edge interrupts feed one EdgeDebouncer per button and push press
+// and release edges, stamped with the edge time, into a lock-free ring
+// straight from the ISR. The ISRs and settle() all run on the button
+// core and take turns under one spinlock, so the ring sees a single
+// producer; the game task is its only consumer and reads it without
+// any kernel call.
+class ButtonInput {
+public:
+    // Configure pins and attach edge interrupts
+    static void init();
+
+    // Reconcile debouncers with the pin levels (call every lockout period)
+    static void settle();
+
+    // Post a press as the edge interrupts do (the host replayer feeds
+    // recorded matches in through here)
+    static void inject(const ButtonEvent& ev);
+
+    // Consumer side (one task only): take the oldest edge, if any
+    static bool next(ButtonEvent& ev) { return _ring.pop(ev); }
+
+    // Consumer side: sleep until a press arrives or ms pass, or return at
+    // once if edges are waiting. Releases alone do not wake the consumer.
+    static void waitForPress(uint32_t ms);
+
+    // Edges lost to a full ring since boot
+    static uint32_t dropped() { return _ring.dropped(); }
+
+private:
+    static void IRAM_ATTR onLeftEdge();
+    static void IRAM_ATTR onRightEdge();
+    static void IRAM_ATTR onEdge(PlayerSide player, EdgeDebouncer& debouncer);
+    static bool IRAM_ATTR readPressed(PlayerSide player);
+    static bool IRAM_ATTR push(PlayerSide player, EdgeType edge, uint32_t nowUs);
+
+    static SpscRing<ButtonEvent, BUTTON_RING_SIZE> _ring;
+    static volatile TaskHandle_t _consumer;  // Woken by presses
+    static EdgeDebouncer _left;
+    static EdgeDebouncer _right;
+    static portMUX_TYPE _mux;
+};
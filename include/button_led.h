@@ -2,11 +2,15 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "rng.h"
 
 // PWM channels for button LEDs
 #define PWM_CHANNEL_LEFT  0
 #define PWM_CHANNEL_RIGHT 1
 
+// Idle breathing step interval
+#define BREATH_INTERVAL_MS 20
+
 class ButtonLED {
 public:
     static void init();
@@ -20,6 +24,7 @@ public:
     // Idle mode effects
     static void updateBreathing();
     static void triggerAttentionPulse();
+    static uint32_t msUntilNextBreath();
 
     // Direct control
     static void setBrightness(bool isLeft, uint8_t brightness);
@@ -31,4 +36,6 @@ private:
     static uint32_t _lastAttentionPulse;
     static bool _inAttentionPulse;
     static uint8_t _attentionPhase;
+    static uint32_t _attentionGapMs;
+    static Rng _rng;
 };
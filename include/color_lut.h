@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// ======================================================
+// Colour Lookup Table
+// ======================================================
+// 256-entry RGB ramp indexed by an 8-bit value (heat, wave height, hue),
+// so an animation's per-LED colour stage is a single table read. Ramps
+// that are plain integer math are built at compile time by makeColorLut()
+// and stay in flash; ramps that need FastLED's colour conversions, which
+// are not constexpr, are filled at reset() with fill().
+struct ColorLut {
+    struct Rgb {
+        uint8_t r, g, b;
+    };
+
+    Rgb entries[256];
+
+    CRGB operator[](uint8_t index) const {
+        const Rgb& c = entries[index];
+        return CRGB(c.r, c.g, c.b);
+    }
+
+    // Fill from ramp(index) -> CRGB at runtime
+    template<typename Ramp>
+    void fill(Ramp ramp) {
+        for (uint16_t i = 0; i < 256; i++) {
+            CRGB c = ramp((uint8_t)i);
+            entries[i] = {c.r, c.g, c.b};
+        }
+    }
+};
+
+// Build a table at compile time from a constexpr ramp(index) -> ColorLut::Rgb
+template<typename Ramp>
+constexpr ColorLut makeColorLut(Ramp ramp) {
+    ColorLut lut = {};
+    for (uint16_t i = 0; i < 256; i++) {
+        lut.entries[i] = ramp((uint8_t)i);
+    }
+    return lut;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+#include "dirty_range.h"
+
+// Maximum number of layers in a compositor
+#define MAX_LAYERS 4
+
+// ======================================================
+// Layer
+// ======================================================
+// How a layer's pixels combine with the layers below it
+enum LayerBlend : uint8_t {
+    BLEND_REPLACE,  // Covered pixels replace what is below
+    BLEND_ADD       // Covered pixels add to what is below (saturating)
+};
+
+// One strip-sized image of which only the covered pixels take part in
+// compositing; everything else is transparent. Layers keep their pixels
+// between frames, so a layer whose inputs did not change is not redrawn,
+// and the changed range tells the compositor what to recomposite.
+class Layer {
+public:
+    explicit Layer(LayerBlend blend) : _blend(blend) {}
+
+    // Make every pixel transparent again
+    void clear();
+
+    void set(uint16_t index, CRGB color);
+    void fill(uint16_t first, uint16_t count, CRGB color);
+
+    LayerBlend blend() const { return _blend; }
+    bool empty() const { return _span.empty(); }
+    bool covers(uint16_t index) const { return _covered[index / 8] & (1 << (index % 8)); }
+    const CRGB& pixel(uint16_t index) const { return _pixels[index]; }
+
+    // Pixels changed since the last call
+    DirtyRange takeChanged();
+
+private:
+    CRGB _pixels[MAX_NUM_LEDS];
+    uint8_t _covered[(MAX_NUM_LEDS + 7) / 8] = {};
+    DirtyRange _span;     // Covers every covered pixel
+    DirtyRange _changed;
+    LayerBlend _blend;
+};
+
+// ======================================================
+// Compositor
+// ======================================================
+// Stack of layers, bottom first, flattened into an LED array in one pass
+// over the pixels that changed in any layer.
+class Compositor {
+public:
+    // Add a layer on top of the stack
+    void add(Layer* layer);
+
+    // Recomposite everything on the next compose(), e.g. after something
+    // else drew into the output array
+    void invalidate() { _valid = false; }
+
+    // Composite the changed pixels into out; returns the range written
+    DirtyRange compose(CRGB* out, uint16_t numLeds);
+
+private:
+    Layer* _layers[MAX_LAYERS] = {};
+    uint8_t _count = 0;
+    bool _valid = false;
+};
@@ -4,12 +4,20 @@
 // Hardware Configuration
 // ======================================================
 #define LED_PIN             5
-#define NUM_LEDS            55
+#define NUM_LEDS_DEFAULT    55      // Strip length until one is saved with "leds N"
+#define MAX_NUM_LEDS        600     // Longest strip the LED buffers are sized for
+#define MIN_NUM_LEDS        (2 * ZONE_SIZE_START + 1)  // Two full zones and a centre LED
 #define LED_TYPE            WS2812B
 #define COLOR_ORDER         GRB
+#ifndef LED_SEGMENT_COUNT
+#define LED_SEGMENT_COUNT   1       // Data lines the strip is split across, sent in parallel (1-8)
+#define LED_SEGMENT_PINS    LED_PIN // One GPIO per segment in strip order, e.g. 5, 16, 4, 2
+#endif
 #define BUTTON_LEFT_PIN     17
 #define BUTTON_RIGHT_PIN    18
 #define BUTTON_ACTIVE_LEVEL LOW
+#define BUTTON_LOCKOUT_US   20000   // Debounce lockout after each accepted edge
+#define BUTTON_RING_SIZE    32      // Press and release edges buffered for the game (power of two)
 
 // Button LEDs (PWM capable pins)
 #define BUTTON_LED_LEFT_PIN  25
@@ -26,6 +34,34 @@
 // Animation Configuration
 // ======================================================
 #define ANIMATION_DURATION_MS  10000UL    // Duration each animation plays before switching
+#define ANIMATION_FADE_MS      1000       // Cross-fade window when switching animations
+#define ANIMATION_FADE_STEP_MS 20         // Blend refresh interval during a cross-fade
+#define ANIMATION_FADE_BUDGET_US 2000     // A fade frame slower than this cuts the fade short
+
+// ======================================================
+// Animation Benchmark
+// ======================================================
+#define BENCH_FRAMES           200     // Frames timed per animation and strip length
+#define BENCH_FRAME_BUDGET_US  1000    // A 99th percentile frame slower than this fails the run
+#define BENCH_EFFECT_MAX_RATIO 2.0f    // Effect programs may cost this much of their native original
+
+// ======================================================
+// Effect Programs
+// ======================================================
+#define EFFECT_DIR             "/effects"  // LittleFS directory scanned for programs at boot
+#define EFFECT_FILES_MAX       4           // Programs loaded from it
+
+// ======================================================
+// Performance Counters
+// ======================================================
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS          1       // 0 compiles the counters and the "perf" command out
+#endif
+
+// ======================================================
+// Randomness
+// ======================================================
+#define RNG_SEED               0       // Master seed for animations and serves; 0 = new one each boot
 
 // ======================================================
 // Game Parameters
@@ -33,6 +69,8 @@
 #define ZONE_SIZE_START     10
 #define ZONE_SIZE_MIN       5
 #define SCORE_TO_WIN        5
+#define BALLS_PER_SERVE     1     // Balls served at once; "balls N" changes it (up to MAX_BALLS)
+#define EFFECT_TICK_MS      10    // Effect refresh interval while waiting on the ball
 
 // ======================================================
 // Ball Speed Control
@@ -48,6 +86,24 @@
 // Max bonus when ball just entered zone, 0 bonus when ball is about to exit
 #define BALL_EARLY_HIT_MAX_BONUS (BALL_INITIAL_DELAY_MS / 8)  // ~7ms bonus at 60ms base
 
+// ======================================================
+// Simulation Clock
+// ======================================================
+// Ball physics runs on a fixed timestep, independent of render cost
+#define SIM_STEP_US             1000                  // 1ms physics step
+#define SIM_MAX_CATCHUP_US      (50 * SIM_STEP_US)    // Drop time beyond this after a stall
+
+// Ball position/velocity are Q16.16 fixed point (one LED = BALL_POS_ONE)
+#define BALL_POS_SHIFT          16
+#define BALL_POS_ONE            (1L << BALL_POS_SHIFT)
+
+// Velocity in LEDs per physics step for a per-LED delay. Returns still cut
+// the delay as above; the velocity is derived from it, so each return
+// gives the speed the delay ramp did.
+#define BALL_VEL_FOR_DELAY(ms)  (BALL_POS_ONE * SIM_STEP_US / ((ms) * 1000L))
+#define BALL_VEL_START          BALL_VEL_FOR_DELAY(BALL_DELAY_START)
+#define BALL_VEL_MAX            BALL_VEL_FOR_DELAY(BALL_DELAY_MIN)
+
 // ======================================================
 // Colors
 // ======================================================
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// ======================================================
+// Dirty Range
+// ======================================================
+// The span of LEDs [first, end) that changed since the last frame. Marks
+// merge into one covering span: gameplay changes cluster around the ball
+// and the overlays, so a single span costs little over-repaint and keeps
+// every consumer a plain loop.
+struct DirtyRange {
+    uint16_t first = 0;
+    uint16_t end = 0;
+
+    bool empty() const { return end <= first; }
+    uint16_t count() const { return empty() ? 0 : end - first; }
+    bool contains(uint16_t index) const { return index >= first && index < end; }
+
+    void mark(uint16_t from, uint16_t n) {
+        if (n == 0) return;
+        if (empty()) {
+            first = from;
+            end = from + n;
+            return;
+        }
+        if (from < first) first = from;
+        if (from + n > end) end = from + n;
+    }
+
+    void mark(const DirtyRange& other) { mark(other.first, other.count()); }
+
+    // Limit to a strip of numLeds
+    DirtyRange clipped(uint16_t numLeds) const {
+        DirtyRange r;
+        if (first < numLeds) r.mark(first, (end < numLeds ? end : numLeds) - first);
+        return r;
+    }
+
+    static DirtyRange all(uint16_t numLeds) {
+        DirtyRange r;
+        r.mark(0, numLeds);
+        return r;
+    }
+};
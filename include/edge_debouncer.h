@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+// ======================================================
+// Edge Debouncer
+// ======================================================
+// Lockout debounce for one button, free of any GPIO code so it can be fed
+// from an interrupt, a poll loop or a recorded bounce trace.
+//
+// The first edge after a quiet period that finds the pin at a new level is
+// accepted at once as a state change, stamped with that edge's time.
+// Further edges within the lockout window are treated as contact bounce
+// and ignored. The state always follows the level read with each edge,
+// never a count of edges, so an edge lost in the lockout window cannot
+// leave it inverted: settle() reads the level again once the window is
+// over and reports the change the lost edge would have.
+enum EdgeType : uint8_t {
+    EDGE_NONE,
+    EDGE_PRESS,
+    EDGE_RELEASE
+};
+
+class EdgeDebouncer {
+public:
+    explicit EdgeDebouncer(uint32_t lockoutUs)
+        : _lockoutUs(lockoutUs), _lastChangeUs(0), _pressed(false), _locked(false) {}
+
+    // A raw edge was seen at nowUs, with the pin read as pressed after it
+    EdgeType onEdge(bool pressed, uint32_t nowUs) { return settle(pressed, nowUs); }
+
+    // Compare against the sampled level; call periodically
+    EdgeType settle(bool pressed, uint32_t nowUs) {
+        if (isLocked(nowUs) || pressed == _pressed) return EDGE_NONE;
+        return change(pressed, nowUs);
+    }
+
+    bool isPressed() const { return _pressed; }
+
+private:
+    bool isLocked(uint32_t nowUs) const {
+        return _locked && (nowUs - _lastChangeUs) < _lockoutUs;
+    }
+
+    EdgeType change(bool pressed, uint32_t nowUs) {
+        _pressed = pressed;
+        _lastChangeUs = nowUs;
+        _locked = true;
+        return pressed ? EDGE_PRESS : EDGE_RELEASE;
+    }
+
+    uint32_t _lockoutUs;
+    uint32_t _lastChangeUs;
+    bool _pressed;
+    bool _locked;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "effect_program.h"
+
+// Longest animation name taken from a file name
+#define EFFECT_NAME_MAX 24
+
+// A program and the name it runs under
+struct EffectSource {
+    const char* name;
+    const uint8_t* code;
+    uint16_t length;
+};
+
+// ======================================================
+// Effect Library
+// ======================================================
+// Effect programs from the LittleFS partition join the attract animations:
+// each valid EFFECT_DIR/<name>.fx is copied into static storage at boot
+// and registered as <name>. The built-in programs re-create native
+// animations of the same name, and AnimationBench times them against the
+// originals.
+class EffectLibrary {
+public:
+    // Call from setup(), before the game task starts; returns programs loaded
+    static uint8_t loadFiles(Print& log);
+
+    static const EffectSource* builtins();
+    static uint8_t builtinCount();
+
+private:
+    struct LoadedEffect {
+        char name[EFFECT_NAME_MAX];
+        uint8_t code[EFFECT_PROGRAM_MAX];
+        uint16_t length;
+        AnimationEntry entry;
+    };
+
+    static Animation* create(void* mem, const void* context);
+
+    static LoadedEffect _loaded[EFFECT_FILES_MAX];
+    static uint8_t _loadedCount;
+};
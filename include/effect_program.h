@@ -0,0 +1,107 @@
+#pragma once
+
+#include "animation.h"
+#include "color_lut.h"
+
+#define EFFECT_VERSION          1
+#define EFFECT_HEADER_SIZE      4
+#define EFFECT_PROGRAM_MAX      128   // Bytes, header included
+#define EFFECT_WAVE_TERMS_MAX   4     // Sine terms in one WAVE
+#define EFFECT_GRADIENT_MAX     8     // Stops in the GRADIENT
+#define EFFECT_TRAILS_MAX       3     // TRAIL ops in one program
+#define EFFECT_TRAIL_RADIUS_MAX 15
+
+// Header bytes: magic "FX", format version, frame interval in ms
+#define EFFECT_HEADER(frameMs) 'F', 'X', EFFECT_VERSION, (frameMs)
+
+// ======================================================
+// Effect Program Format
+// ======================================================
+// A program is the header above followed by ops: an opcode byte and its
+// operands, 16-bit operands little-endian. Each frame runs the ops in
+// order over two buffers: the LED frame, which persists between frames
+// so FADE leaves trails behind moving things, and an 8-bit value per LED
+// that WAVE writes and PALETTE maps to colour. The frame counter t
+// starts at 1 on the first frame.
+//
+//   FILL r g b             Set every LED
+//   FADE amount            Dim every LED towards black by amount/256
+//   WAVE n {w s k p}*n     value[i] = weighted mean (weights w) of
+//                          sin8(t*s + i*k + p), rounded
+//   PALETTE id             led[i] = palette[value[i]]
+//   GRADIENT n {x r g b}*n Stops of EFFECT_PALETTE_CUSTOM, built once at
+//                          reset; value x takes colour rgb, linear between
+//                          (a program using PALETTE EFFECT_PALETTE_CUSTOM
+//                          must have one)
+//   TRAIL radius sigma:16 start speed motion  rc gc bc  re ge be
+//                          A glow moving speed LEDs per frame (negative
+//                          starts it leftwards) from start/256 along the
+//                          strip. Gaussian falloff with sigma in 1/100
+//                          LED out to radius, centre colour to edge
+//                          colour. Motion 0 leaves the strip completely
+//                          before turning back, motion 1 wraps around.
+//   PARTICLE n chance r g b
+//                          n tries per frame, each lighting a random LED
+//                          with probability chance%
+enum EffectOp : uint8_t {
+    EFFECT_OP_FILL = 1,
+    EFFECT_OP_FADE,
+    EFFECT_OP_WAVE,
+    EFFECT_OP_PALETTE,
+    EFFECT_OP_GRADIENT,
+    EFFECT_OP_TRAIL,
+    EFFECT_OP_PARTICLE
+};
+
+enum EffectPalette : uint8_t {
+    EFFECT_PALETTE_CUSTOM,   // From the program's GRADIENT
+    EFFECT_PALETTE_OCEAN,    // OCEAN_COLORS
+    EFFECT_PALETTE_COUNT
+};
+
+enum EffectMotion : uint8_t {
+    EFFECT_MOTION_BOUNCE,
+    EFFECT_MOTION_WRAP
+};
+
+// Checks the header, every opcode and operand and the limits above, so the
+// interpreter can run a program without checking anything per frame
+bool effectProgramValid(const uint8_t* code, uint16_t length);
+
+// ======================================================
+// Effect Animation
+// ======================================================
+// Runs a validated effect program as an attract animation. Ops that touch
+// LEDs loop over the strip in native code, so the interpreter only pays
+// for dispatch once per op per frame. The program is not copied: it must
+// outlive the animation (flash or the effect library's storage).
+class EffectAnimation : public Animation {
+public:
+    EffectAnimation(const char* name, const uint8_t* code, uint16_t length)
+        : Animation(name), _code(code), _length(length), _time(0) {}
+
+    void reset() override;
+    uint16_t frameIntervalMs() const override { return _code[3]; }
+    bool update(CRGB* leds, uint16_t numLeds) override;
+
+private:
+    struct Trail {
+        int16_t pos;
+        int8_t dir;
+        CRGB colors[EFFECT_TRAIL_RADIUS_MAX + 1];  // Glow by distance from centre
+    };
+
+    void wave(const uint8_t* op, uint16_t numLeds);
+    void palette(const uint8_t* op, CRGB* leds, uint16_t numLeds);
+    void trail(const uint8_t* op, Trail& state, CRGB* leds, uint16_t numLeds);
+    void particles(const uint8_t* op, CRGB* leds, uint16_t numLeds);
+    void buildGradient(const uint8_t* op);
+    void startTrail(const uint8_t* op, Trail& state);
+
+    const uint8_t* _code;
+    uint16_t _length;
+    uint16_t _time;
+    Trail _trails[EFFECT_TRAILS_MAX];
+    uint8_t _values[MAX_NUM_LEDS];
+    ColorLut _custom;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+#include "compositor.h"
+
+// Maximum number of keyframes that can be pending at once
+#define MAX_EFFECT_KEYFRAMES 32
+
+// ======================================================
+// Effect Keyframes
+// ======================================================
+enum EffectTarget : uint8_t {
+    EFFECT_BUTTON_LEFT,   // Left button LED brightness
+    EFFECT_BUTTON_RIGHT,  // Right button LED brightness
+    EFFECT_STRIP          // Solid colour overlay on a range of the strip
+};
+
+struct EffectKeyframe {
+    uint32_t     startMs;     // Absolute start time (millis)
+    uint16_t     durationMs;
+    EffectTarget target;
+    uint8_t      from;        // Button LEDs: brightness ramps from -> to
+    uint8_t      to;
+    uint16_t     first;       // Strip: overlay covers [first, first + count)
+    uint16_t     count;
+    CRGB         color;
+};
+
+// ======================================================
+// Effect Scheduler
+// ======================================================
+// Timeline of button LED and strip keyframes. Effects post keyframes and
+// return immediately; the game loop calls tick() and render() once per
+// iteration, so feedback plays out while the ball keeps moving.
+class EffectScheduler {
+public:
+    // Post keyframes starting delayMs from now
+    static void postButton(bool isLeft, uint32_t delayMs, uint16_t durationMs,
+                           uint8_t from, uint8_t to);
+    static void postStrip(uint32_t delayMs, uint16_t durationMs,
+                          uint16_t first, uint16_t count, CRGB color);
+
+    // Drive button LEDs from active keyframes and retire finished ones
+    static void tick();
+
+    // Overlay active strip keyframes; returns true if any were drawn
+    static bool render(CRGB* leds, uint16_t numLeds) { return render(leds, numLeds, millis()); }
+    static bool render(CRGB* leds, uint16_t numLeds, uint32_t now);
+
+    // Draw active strip keyframes into a layer instead
+    static bool render(Layer& layer, uint16_t numLeds, uint32_t now);
+
+    // True while any keyframe is pending or playing
+    static bool isBusy() { return _count > 0; }
+
+    // True while the scheduler is driving this button LED
+    static bool ownsButton(bool isLeft);
+
+    // Drop all pending keyframes
+    static void clear() { _count = 0; }
+
+private:
+    static void post(const EffectKeyframe& keyframe);
+
+    static EffectKeyframe _keyframes[MAX_EFFECT_KEYFRAMES];
+    static uint8_t _count;
+};
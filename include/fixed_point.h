@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+
+// ======================================================
+// Fixed Point
+// ======================================================
+// Signed fixed-point number with FRAC fraction bits stored in Raw; products
+// are formed in Wide before shifting back. Conversions to integers floor
+// (arithmetic shift), like the ball position in main.cpp. Use fromFloat()
+// for compile-time constants only: the point is to keep floats out of the
+// per-frame paths.
+template<uint8_t FRAC, typename Raw, typename Wide>
+class Fixed {
+public:
+    static constexpr Raw ONE = (Raw)1 << FRAC;
+
+    constexpr Fixed() : _raw(0) {}
+
+    static constexpr Fixed fromRaw(Raw raw) { return Fixed(raw, 0); }
+    static constexpr Fixed fromInt(int32_t value) { return Fixed((Raw)(value * ONE), 0); }
+    static constexpr Fixed fromFloat(float value) {
+        return Fixed((Raw)(value * ONE + (value < 0 ? -0.5f : 0.5f)), 0);
+    }
+
+    // num / den, rounded up, so scaling an integer by it and flooring gives
+    // the exact floor(value * num / den). num << FRAC must fit in 32 bits.
+    static constexpr Fixed fromRatio(int32_t num, int32_t den) {
+        return Fixed((Raw)(num * (int32_t)ONE >= 0 ? (num * (int32_t)ONE + den - 1) / den
+                                                   : num * (int32_t)ONE / den), 0);
+    }
+
+    constexpr Raw raw() const { return _raw; }
+    constexpr int32_t toInt() const { return _raw >> FRAC; }
+    float toFloat() const { return (float)_raw / ONE; }
+
+    // value * this, floored
+    constexpr int32_t scale(int32_t value) const { return (int32_t)(((Wide)value * _raw) >> FRAC); }
+
+    // a + (b - a) * t, floored; t = 0 gives a, t = ONE gives b
+    static constexpr int32_t lerp(int32_t a, int32_t b, Fixed t) { return a + t.scale(b - a); }
+    static constexpr Fixed lerp(Fixed a, Fixed b, Fixed t) { return a + (b - a) * t; }
+
+    constexpr Fixed clamp(Fixed lo, Fixed hi) const { return *this < lo ? lo : (hi < *this ? hi : *this); }
+    constexpr Fixed abs() const { return _raw < 0 ? Fixed(-_raw, 0) : *this; }
+
+    constexpr Fixed operator-() const { return Fixed(-_raw, 0); }
+    constexpr Fixed operator+(Fixed o) const { return Fixed(_raw + o._raw, 0); }
+    constexpr Fixed operator-(Fixed o) const { return Fixed(_raw - o._raw, 0); }
+    constexpr Fixed operator*(Fixed o) const { return Fixed((Raw)(((Wide)_raw * o._raw) >> FRAC), 0); }
+    constexpr Fixed operator*(int32_t k) const { return Fixed((Raw)(_raw * k), 0); }
+    constexpr Fixed operator/(int32_t k) const { return Fixed((Raw)(_raw / k), 0); }
+    Fixed& operator+=(Fixed o) { _raw += o._raw; return *this; }
+    Fixed& operator-=(Fixed o) { _raw -= o._raw; return *this; }
+
+    constexpr bool operator<(Fixed o) const { return _raw < o._raw; }
+    constexpr bool operator>(Fixed o) const { return _raw > o._raw; }
+    constexpr bool operator<=(Fixed o) const { return _raw <= o._raw; }
+    constexpr bool operator>=(Fixed o) const { return _raw >= o._raw; }
+    constexpr bool operator==(Fixed o) const { return _raw == o._raw; }
+    constexpr bool operator!=(Fixed o) const { return _raw != o._raw; }
+
+private:
+    constexpr Fixed(Raw raw, int) : _raw(raw) {}
+
+    Raw _raw;
+};
+
+typedef Fixed<8, int16_t, int32_t>  Q8_8;    // +/-128, 1/256 steps: colour fractions
+typedef Fixed<16, int32_t, int64_t> Q16_16;  // +/-32768, 1/65536 steps: positions, speeds
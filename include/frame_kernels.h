@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+
+// ======================================================
+// Frame Kernels
+// ======================================================
+// The whole-strip loops that run on every frame: wire encoding on the
+// output task and the cross-fade blend. The strip length is only known at
+// runtime, so the blend dispatches to a copy compiled for a fixed length
+// when it matches one of the short common ones (NUM_LEDS_DEFAULT and 150)
+// and falls back to a runtime-length loop otherwise. The fixed copies let
+// the compiler unroll and drop the bounds bookkeeping, which only matters
+// on short strips: the benchmark shows the blend about 20% faster at 55
+// and 150 LEDs, and no gain from 300 up. Encoding showed no gain at any
+// length and is a single runtime-length loop.
+class FrameKernels {
+public:
+    // Scale src by brightness and reorder to COLOR_ORDER: 3 * numLeds bytes
+    static void encode(uint8_t* dest, const CRGB* src, uint16_t numLeds, uint8_t brightness);
+
+    // dest = from blended towards to by amount (0 = from, 255 = to)
+    static void blend(CRGB* dest, const CRGB* from, const CRGB* to, uint16_t numLeds, fract8 amount);
+
+    // Runtime-length blend the dispatch falls back to
+    static void blendGeneric(CRGB* dest, const CRGB* from, const CRGB* to, uint16_t numLeds, fract8 amount);
+
+    // True if numLeds has a fixed-length blend
+    static bool isSpecialised(uint16_t numLeds);
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+// ======================================================
+// Shared Game Types
+// ======================================================
+enum PlayerSide : uint8_t { PLAYER_LEFT = 0, PLAYER_RIGHT = 1 };
+
+struct ButtonEvent {
+    PlayerSide player;
+    bool       pressed;      // Press, or release
+    uint32_t   timestampUs;  // micros() at the first edge of the change
+};
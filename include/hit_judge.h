@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include "game_types.h"
+#include "fixed_point.h"
+
+// Number of ball LED entries kept for judging late-processed presses
+#define BALL_HISTORY_SIZE 32
+
+// ======================================================
+// Ball History
+// ======================================================
+// Ring buffer of the times the ball entered each LED, so a press can be
+// judged against where the ball was when the button went down rather
+// than where it is when the game loop gets round to it.
+struct BallSample {
+    uint32_t timeUs;  // When the ball entered pos (or changed direction)
+    int16_t  pos;
+    int8_t   dir;
+};
+
+class BallHistory {
+public:
+    BallHistory() : _head(0), _count(0) {}
+
+    void clear() { _head = 0; _count = 0; }
+    void record(uint32_t timeUs, int16_t pos, int8_t dir);
+
+    // Ball state at timeUs: the latest sample at or before it, or the
+    // oldest one kept if the press predates the history
+    bool sampleAt(uint32_t timeUs, BallSample& out) const;
+
+private:
+    BallSample _samples[BALL_HISTORY_SIZE];
+    uint8_t _head;   // Next slot to write
+    uint8_t _count;
+};
+
+// ======================================================
+// Hit Judgement
+// ======================================================
+enum HitOutcome : uint8_t {
+    HIT_RETURN,   // Ball was in the player's zone: return it
+    HIT_PENALTY   // Pressed while the ball was outside the zone
+};
+
+struct HitJudgement {
+    HitOutcome outcome;
+    int16_t    pos;          // Ball LED at the moment of the press
+    Q16_16     earlyFactor;  // 1.0 at zone entry, 0.0 at zone exit
+};
+
+// Judge a press by player at pressUs against the ball's history
+HitJudgement judgePress(const BallHistory& history, PlayerSide player, uint32_t pressUs,
+                        uint8_t zoneSize, uint16_t numLeds);
+
+// True if pos lies inside the player's zone
+bool inZone(PlayerSide player, int pos, uint8_t zoneSize, uint16_t numLeds);
+
+// Early-hit factor: 1.0 as the ball enters the zone, 0.0 as it leaves
+// Left zone: entry at zoneSize-1, exit at 0
+// Right zone: entry at numLeds-zoneSize, exit at numLeds-1
+Q16_16 earlyHitFactor(PlayerSide player, int pos, uint8_t zoneSize, uint16_t numLeds);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "config.h"
+#include "triple_buffer.h"
+#include "led_segment_map.h"
+#include "dirty_range.h"
+
+// ======================================================
+// Frame Timing
+// ======================================================
+struct LedFrameTiming {
+    uint32_t submitUs;    // show() called
+    uint32_t startUs;     // Transmission started on the output task
+    uint32_t completeUs;  // Frame latched on the strip
+    uint32_t dropped;     // Frames replaced by a newer one before sending
+};
+
+// ======================================================
+// LED Output
+// ======================================================
+// Asynchronous strip output on its own task. show() copies the LED array
+// into a triple buffer and returns at once; the output task takes the
+// newest frame, encodes it and sends it while the game keeps running.
+// Nothing is sent between frames: the LEDs latch the last one, so a frame
+// where nothing changed is neither published nor transmitted. A brightness
+// change takes effect with the next frame.
+//
+// The strip is split into LED_SEGMENT_COUNT segments (see LedSegmentMap),
+// each on its own data pin, and all segments are sent at once: the frame
+// takes as long as its longest segment. Callers still see one contiguous
+// LED array.
+//
+// Each frame carries the range that changed since the previous one. When
+// the output task sends consecutive frames it re-encodes only that range;
+// after a dropped frame, a brightness or length change it encodes them all.
+//
+// On ESP32 the transmitter is one RMT channel per segment, converting bytes
+// to WS2812 pulses from its own interrupt. The host build models the wire
+// time instead, and runs each segment's bitstream back through the decoder
+// to check it reassembles into the frame that was shown.
+class LedOutput {
+public:
+    static void init(CRGB* leds, uint16_t numLeds);
+    static void setBrightness(uint8_t brightness) { _brightness = brightness; }
+
+    // Change how many LEDs show() sends (up to MAX_NUM_LEDS). LEDs cut off
+    // by a shorter strip are blanked by the next frame sent.
+    static void setLength(uint16_t numLeds);
+    static uint16_t length() { return _numLeds; }
+
+    // Publish the current LED array to the output task (never blocks)
+    static void show() { show(DirtyRange::all(MAX_NUM_LEDS)); }
+
+    // Publish a frame where only the LEDs in dirty changed; nothing is
+    // published if it is empty
+    static void show(const DirtyRange& dirty);
+
+    // Output task: begin() once, then call service() in a loop
+    static void begin();
+    static void service();
+
+    // Timing of the most recently sent frame (call from one task only)
+    static LedFrameTiming lastTiming();
+
+    // Frames published by show() since boot
+    static uint32_t frameCount() { return _frameCount; }
+
+    // Wire time for a segment of numLeds (24 bits at 800kHz plus latch)
+    static uint32_t wireTimeUs(uint16_t numLeds);
+
+    // FNV-1a hash of every frame shown between start and stop, so a
+    // replayed match can be checked frame for frame
+    static void startFrameHash();
+    static uint32_t stopFrameHash();
+
+    // Frames whose decoded bitstreams did not match (host build only)
+    static uint32_t wireErrors() { return _wireErrors; }
+
+private:
+    struct Frame {
+        CRGB leds[MAX_NUM_LEDS];
+        uint16_t numLeds;
+        DirtyRange dirty;  // Changed since the frame before
+        uint32_t submitUs;
+        uint32_t seq;
+    };
+
+    static void transmit(const Frame& frame);
+    static void encode(const Frame& frame, uint8_t brightness);
+    static void encodeRange(const Frame& frame, uint8_t brightness);
+    static void startTransmit(uint8_t segment, const uint8_t* data, size_t len);
+    static bool transmitDone();
+    static void waitIdle();
+    static void verifyFrame(const Frame& frame);
+
+    static CRGB* _leds;
+    static uint16_t _numLeds;
+    static volatile uint8_t _brightness;
+    static TaskHandle_t _task;
+    static TripleBuffer<Frame> _frames;
+    static TripleBuffer<LedFrameTiming> _timings;
+    static uint32_t _frameCount;
+    static bool _hashing;
+    static uint32_t _frameHash;
+
+    // Output task only
+    static LedSegmentMap _map;
+    static uint8_t _wire[LED_SEGMENT_COUNT][LED_SEGMENT_MAX_LEDS * 3];
+    static uint16_t _sendLeds[LED_SEGMENT_COUNT];  // Per segment, this frame
+    static uint16_t _sentLeds[LED_SEGMENT_COUNT];  // Per segment, lit on the strip
+    static uint32_t _wireErrors;
+    static volatile bool _busy;
+    static uint32_t _completeUs;
+    static uint32_t _lastSeq;
+    static uint32_t _encodedSeq;       // Frame the wire buffers hold
+    static uint8_t _encodedBrightness;
+    static uint32_t _dropped;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+// Longest segment any strip length can produce; sizes per-segment buffers
+#define LED_SEGMENT_MAX_LEDS ((MAX_NUM_LEDS + LED_SEGMENT_COUNT - 1) / LED_SEGMENT_COUNT)
+
+// ======================================================
+// LED Segment
+// ======================================================
+// A run of the logical strip wired to its own data pin. Segment 0 holds
+// the first LEDs; each segment's first LED sits next to its data input.
+struct LedSegment {
+    uint8_t  pin;
+    uint16_t first;  // Logical index of the segment's first LED
+    uint16_t count;
+};
+
+// ======================================================
+// LED Segment Map
+// ======================================================
+// Splits the logical strip the game draws into LED_SEGMENT_COUNT segments,
+// one per pin in LED_SEGMENT_PINS, so they can be sent in parallel. The
+// split is as even as possible: earlier segments take one extra LED when
+// the length does not divide.
+class LedSegmentMap {
+public:
+    LedSegmentMap() : _numLeds(0) { layout(0); }
+
+    // Recompute the table for a strip of numLeds
+    void layout(uint16_t numLeds);
+
+    uint16_t numLeds() const { return _numLeds; }
+    uint8_t count() const { return LED_SEGMENT_COUNT; }
+    const LedSegment& operator[](uint8_t segment) const { return _segments[segment]; }
+
+    // Logical LED index to (segment, offset within segment)
+    // Returns false if index is past the end of the strip
+    bool locate(uint16_t index, uint8_t& segment, uint16_t& offset) const;
+
+    // Data pin of a segment
+    static uint8_t pin(uint8_t segment);
+
+private:
+    LedSegment _segments[LED_SEGMENT_COUNT];
+    uint16_t _numLeds;
+};
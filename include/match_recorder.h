@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "game_types.h"
+
+// Longest match a log holds; presses past it are not recorded
+#define MATCH_LOG_MAX_EVENTS 512
+
+#define MATCH_LOG_MAGIC   0x474F4C50UL  // "PLOG"
+#define MATCH_LOG_VERSION 1
+
+// ======================================================
+// Match Log
+// ======================================================
+// Everything a match depends on besides the firmware itself: the settings
+// and serve seed it was played with and every press, in the order the
+// game read them. Stored as this header followed by eventCount packed
+// events, little-endian as both the ESP32 and the host are.
+struct MatchSettings {
+    uint32_t seed;           // Serve randomness
+    uint16_t stripLength;
+    uint8_t  ballsPerServe;
+};
+
+struct MatchLogHeader {
+    uint32_t magic;          // MATCH_LOG_MAGIC
+    uint8_t  version;        // MATCH_LOG_VERSION
+    uint8_t  ballsPerServe;
+    uint16_t stripLength;
+    uint32_t seed;
+    uint32_t startUs;        // micros() when the match began
+    uint32_t frameHash;      // LedOutput::frameHash() over the match
+    uint16_t eventCount;
+    uint8_t  scoreLeft;
+    uint8_t  scoreRight;
+};
+
+static_assert(sizeof(MatchLogHeader) == 24, "MatchLogHeader must stay unpadded");
+
+// One press: bit 31 is the player, bits 0-30 the signed microseconds from
+// startUs (presses queued before the match began come out negative)
+inline uint32_t packMatchEvent(const ButtonEvent& ev, uint32_t startUs) {
+    return ((uint32_t)ev.player << 31) | ((ev.timestampUs - startUs) & 0x7FFFFFFFUL);
+}
+
+inline int32_t matchEventOffsetUs(uint32_t packed) {
+    return (int32_t)(packed << 1) >> 1;
+}
+
+inline ButtonEvent unpackMatchEvent(uint32_t packed, uint32_t startUs) {
+    ButtonEvent ev;
+    ev.player = (PlayerSide)(packed >> 31);
+    ev.pressed = true;
+    ev.timestampUs = startUs + matchEventOffsetUs(packed);
+    return ev;
+}
+
+// ======================================================
+// Match Recorder
+// ======================================================
+// Logs the match in play. The game task calls begin() when a press starts
+// a match, record() for every press it reads, and end() once the match is
+// decided. Listeners hear about both ends: the host sim writes finished
+// logs to a file and schedules replayed presses from the start.
+//
+// A log queued with replayNext() makes the next begin() play with its
+// settings instead, so a replay serves exactly as the original did.
+class MatchRecorder {
+public:
+    typedef void (*Listener)(const MatchLogHeader& header, const uint32_t* events);
+
+    // Start logging; returns the settings to play the match with
+    static MatchSettings begin(const MatchSettings& settings, uint32_t startUs);
+    static void record(const ButtonEvent& ev);
+    static void end(uint8_t scoreLeft, uint8_t scoreRight);
+
+    static void replayNext(const MatchSettings& settings);
+    static void setListeners(Listener started, Listener finished) {
+        _started = started;
+        _finished = finished;
+    }
+
+    // Match being recorded, or the last one
+    static const MatchLogHeader& header() { return _header; }
+    static const uint32_t* events() { return _events; }
+
+    // Write the last finished match as one "matchlog <hex>" line
+    static void dump(Print& out);
+
+private:
+    static MatchLogHeader _header;
+    static uint32_t _events[MATCH_LOG_MAX_EVENTS];
+    static bool _recording;
+    static bool _replayQueued;
+    static MatchSettings _replay;
+    static Listener _started;
+    static Listener _finished;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "color_lut.h"
+#include "fixed_point.h"
+
+// ======================================================
+// Shared Palettes
+// ======================================================
+// Colour ramps used by both native animations and effect programs. They
+// are built at compile time, so each lives once in flash.
+
+// Wave height (255 = crest) to ocean colour: deep blue to cyan, with white
+// foam above 0.85
+inline constexpr ColorLut OCEAN_COLORS = makeColorLut([](uint8_t height) {
+    Q16_16 combined = Q16_16::fromRatio(height, 255);
+    int32_t blue = Q16_16::lerp(80, 255, combined);
+    int32_t green = Q16_16::lerp(20, 120, combined);
+    int32_t red = combined.scale(30);
+
+    int32_t foam = combined.scale(1700) - 1445;
+    if (foam > 0) {
+        red += foam;
+        green += foam;
+        blue += foam;
+    }
+    auto sat8 = [](int32_t v) { return (uint8_t)(v > 255 ? 255 : v); };
+    return ColorLut::Rgb{sat8(red), sat8(green), sat8(blue)};
+});
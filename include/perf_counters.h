@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+#if PERF_COUNTERS
+#include <atomic>
+#endif
+
+// Events counted since boot or the last reset
+enum PerfCounter : uint8_t {
+    PERF_INPUT_EDGES,        // Press and release edges posted for the game
+    PERF_INPUT_DROPS,        // Edges lost to a full input ring
+    PERF_CATCHUP_DROPS,      // Stalls long enough to drop physics time
+    PERF_COUNTER_COUNT
+};
+
+// Durations sorted into power-of-two microsecond buckets
+enum PerfHistogram : uint8_t {
+    PERF_GAME_LOOP_US,       // One STATE_BALL_MOVING iteration, sleep excluded
+    PERF_SHOW_US,            // LedOutput::show() on the game task
+    PERF_TRANSMIT_US,        // Encode and send of one frame on the output task
+    PERF_FADE_US,            // Worst frame of each attract cross-fade
+    PERF_HISTOGRAM_COUNT
+};
+
+// Bucket 0 holds 0us, bucket b holds [2^(b-1), 2^b) us and the last one
+// everything from 2^(PERF_BUCKETS-2) us up
+#define PERF_BUCKETS   16
+#define PERF_MAX_TASKS 4
+
+#if PERF_COUNTERS
+
+// ======================================================
+// Performance Counters
+// ======================================================
+// Counters and histograms in fixed static arrays, bumped with relaxed
+// atomic increments so ISRs and tasks on either core can update them
+// without locks. Stack headroom is read from watched tasks on dump.
+class PerfCounters {
+public:
+    static void count(PerfCounter counter) {
+        _counts[counter].fetch_add(1, std::memory_order_relaxed);
+    }
+    static void sample(PerfHistogram histogram, uint32_t us);
+
+    // Report this task's unused stack on dump
+    static void watchTask(TaskHandle_t task, const char* name, uint32_t stackBytes);
+
+    static uint8_t bucketFor(uint32_t us) {
+        uint8_t b = (us == 0) ? 0 : 32 - __builtin_clz(us);
+        return b < PERF_BUCKETS ? b : PERF_BUCKETS - 1;
+    }
+
+    static uint32_t counter(PerfCounter counter) { return _counts[counter].load(std::memory_order_relaxed); }
+    static uint32_t bucket(PerfHistogram histogram, uint8_t b) {
+        return _buckets[histogram][b].load(std::memory_order_relaxed);
+    }
+    static uint32_t maxUs(PerfHistogram histogram) { return _maxUs[histogram].load(std::memory_order_relaxed); }
+
+    static void reset();
+
+    // One "perf" line per counter group, histogram and the task stacks
+    static void dump(Print& out);
+
+private:
+    struct WatchedTask {
+        TaskHandle_t task;
+        const char* name;
+        uint32_t stackBytes;
+    };
+
+    static std::atomic<uint32_t> _counts[PERF_COUNTER_COUNT];
+    static std::atomic<uint32_t> _buckets[PERF_HISTOGRAM_COUNT][PERF_BUCKETS];
+    static std::atomic<uint32_t> _maxUs[PERF_HISTOGRAM_COUNT];
+    static WatchedTask _tasks[PERF_MAX_TASKS];
+    static uint8_t _taskCount;
+};
+
+// Samples the time from construction to stop() or the end of the scope
+class PerfTimer {
+public:
+    explicit PerfTimer(PerfHistogram histogram) : _histogram(histogram), _startUs(micros()), _running(true) {}
+    ~PerfTimer() { stop(); }
+
+    void stop() {
+        if (!_running) return;
+        _running = false;
+        PerfCounters::sample(_histogram, micros() - _startUs);
+    }
+
+private:
+    PerfHistogram _histogram;
+    uint32_t _startUs;
+    bool _running;
+};
+
+#else
+
+// Counters compiled out: every call is an empty inline
+class PerfCounters {
+public:
+    static void count(PerfCounter) {}
+    static void sample(PerfHistogram, uint32_t) {}
+    static void watchTask(TaskHandle_t, const char*, uint32_t) {}
+};
+
+class PerfTimer {
+public:
+    explicit PerfTimer(PerfHistogram) {}
+    void stop() {}
+};
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+// Independent random streams, each derived from the master seed
+#define RNG_STREAM_GAME       1
+#define RNG_STREAM_BUTTON_LED 2
+#define RNG_STREAM_ANIMATION  0x100  // + animation index
+
+// ======================================================
+// Random Number Generator
+// ======================================================
+// xorshift32: three shifts and xors per number, no division, no locks, and
+// the whole state is one word, so every animation can own one. All streams
+// come from a single master seed, which is printed at boot: setting
+// RNG_SEED to it replays the same sparks, drops and serves.
+class Rng {
+public:
+    explicit Rng(uint32_t seed = 1) { reseed(seed); }
+
+    // xorshift has a fixed point at zero, so a zero seed is replaced
+    void reseed(uint32_t seed) { _state = seed ? seed : 0x9E3779B9u; }
+
+    uint32_t next() {
+        uint32_t x = _state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        _state = x;
+        return x;
+    }
+
+    // Uniform in [0, n): multiply-high instead of modulo
+    uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next() * n) >> 32); }
+
+    // Uniform in [lo, hi), like Arduino's random(lo, hi). The span is taken
+    // unsigned, so ranges wider than INT32_MAX do not overflow.
+    int32_t range(int32_t lo, int32_t hi) {
+        return hi > lo ? (int32_t)((uint32_t)lo + below((uint32_t)hi - (uint32_t)lo)) : lo;
+    }
+
+    // True with probability percent / 100
+    bool chance(uint8_t percent) { return below(100) < percent; }
+
+    // Generator for one stream of the master seed
+    static Rng stream(uint32_t id) { return Rng(mix(_masterSeed ^ mix(id))); }
+
+    static void setMasterSeed(uint32_t seed) { _masterSeed = seed; }
+    static uint32_t masterSeed() { return _masterSeed; }
+
+private:
+    // MurmurHash3 finaliser: neighbouring stream ids get unrelated states
+    static uint32_t mix(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return x;
+    }
+
+    uint32_t _state;
+    static uint32_t _masterSeed;
+};
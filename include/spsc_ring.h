@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// ======================================================
+// SPSC Ring
+// ======================================================
+// Lock-free FIFO from one producer to one consumer. Each index is written
+// by one side only, so push() and pop() never wait: a full ring drops the
+// new item and counts it instead.
+//
+// Indices run freely and wrap through the mask, so N must be a power of
+// two and the ring holds all N items.
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side; returns false (and counts a drop) if the ring is full
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false if there is nothing to read
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _tail.load(std::memory_order_relaxed) == _head.load(std::memory_order_acquire);
+    }
+
+    // Items lost to a full ring so far
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    T _items[N] = {};
+    std::atomic<uint32_t> _head{0};     // Next slot to fill, producer only
+    std::atomic<uint32_t> _tail{0};     // Next slot to read, consumer only
+    std::atomic<uint32_t> _dropped{0};  // Producer only
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+// ======================================================
+// Strip Configuration
+// ======================================================
+// Strip length chosen at runtime and kept in NVS, so one firmware build
+// drives anything from the 55-LED table up to chained MAX_NUM_LEDS strips.
+// Set it from the serial console with "leds N"; it survives reboots.
+class StripConfig {
+public:
+    // Read the saved length (NUM_LEDS_DEFAULT if none or out of range)
+    static void load();
+
+    // Current strip length
+    static uint16_t length() { return _length; }
+
+    // Validate and save a new length; returns false if out of range
+    static bool store(uint16_t numLeds);
+
+    static bool isValid(long numLeds) {
+        return numLeds >= MIN_NUM_LEDS && numLeds <= MAX_NUM_LEDS;
+    }
+
+private:
+    static uint16_t _length;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// ======================================================
+// Triple Buffer
+// ======================================================
+// Lock-free handoff of whole values from one producer task to one consumer
+// task. The producer fills back() and publish()es it; the consumer calls
+// acquire() and reads front(). Neither side ever waits: the producer always
+// has a free slot, and the consumer always sees the newest published value
+// (older unread ones are overwritten).
+//
+// Slots are exchanged through a single atomic index, so each side owns its
+// slot exclusively between calls.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& back() { return _slots[_back]; }
+    void publish() {
+        uint32_t prev = _middle.exchange(_back | FRESH, std::memory_order_acq_rel);
+        _back = prev & INDEX_MASK;
+    }
+
+    // Consumer side; returns true if a newer value was taken
+    bool acquire() {
+        if (!(_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint32_t prev = _middle.exchange(_front, std::memory_order_acq_rel);
+        _front = prev & INDEX_MASK;
+        return true;
+    }
+    const T& front() const { return _slots[_front]; }
+
+private:
+    static const uint32_t INDEX_MASK = 0x3;
+    static const uint32_t FRESH = 0x4;
+
+    T _slots[3] = {};
+    uint8_t _back = 0;                 // Producer only
+    uint8_t _front = 1;                // Consumer only
+    std::atomic<uint32_t> _middle{2};  // Shared slot index plus FRESH flag
+};
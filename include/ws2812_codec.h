@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Symbol timing in 25ns ticks (RMT at 80MHz APB / 2)
+#define WS2812_TICK_NS  25
+#define WS2812_T0H      16  // 0.40us
+#define WS2812_T0L      34  // 0.85us
+#define WS2812_T1H      32  // 0.80us
+#define WS2812_T1L      18  // 0.45us
+#define WS2812_TOL      6   // Decoder tolerance, +/-150ns as in the datasheet
+
+// One bit: high for h ticks, then low for l ticks (rmt_item32_t layout)
+#define WS2812_SYMBOL(h, l) ((uint32_t)(h) | (1UL << 15) | ((uint32_t)(l) << 16))
+#define WS2812_BIT0         WS2812_SYMBOL(WS2812_T0H, WS2812_T0L)
+#define WS2812_BIT1         WS2812_SYMBOL(WS2812_T1H, WS2812_T1L)
+
+// ======================================================
+// WS2812 Bitstream Codec
+// ======================================================
+// Converts wire bytes to the pulse symbols a WS2812 data line carries and
+// back. A symbol is one bit: a high pulse then a low pulse, packed like the
+// ESP32's rmt_item32_t (duration0:15, level0:1, duration1:15, level1:1), so
+// the RMT translator hands encode() its item buffer directly. decode() reads
+// the stream the way a strip would, which lets the host build check every
+// segment it "sends".
+class Ws2812Codec {
+public:
+    // Encode whole bytes, MSB first, until len bytes or maxSymbols symbols
+    // are used. Returns bytes consumed; *symbolCount receives symbols written.
+    static size_t encode(const uint8_t* bytes, size_t len, uint32_t* symbols,
+                         size_t maxSymbols, size_t* symbolCount);
+
+    // Decode symbols back into bytes. Returns the byte count, or -1 if a
+    // symbol is not a valid bit or the stream ends mid-byte.
+    static int32_t decode(const uint32_t* symbols, size_t count, uint8_t* bytes);
+};
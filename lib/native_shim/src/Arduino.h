@@ -0,0 +1,190 @@
+#pragma once
+
+// ======================================================
+// Arduino-ESP32 API shim for the native build
+// ======================================================
+// Only the subset the firmware uses. Timing, tasks and queues are routed
+// through the simulation kernel in sim.h so everything runs against the
+// virtual clock.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "sim.h"
+
+using std::min;
+using std::max;
+using std::abs;
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define digitalPinToInterrupt(p) (p)
+
+// ------------------------------------------------------
+// Time
+// ------------------------------------------------------
+inline unsigned long micros() { sim::consumeUs(1); return (unsigned long)(uint32_t)sim::nowUs(); }
+inline unsigned long millis() { sim::consumeUs(1); return (unsigned long)(uint32_t)(sim::nowUs() / 1000); }
+void delay(uint32_t ms);
+inline void delayMicroseconds(uint32_t us) { sim::consumeUs(us); }
+inline void yield() { sim::yield(); }
+
+// ------------------------------------------------------
+// GPIO / PWM
+// ------------------------------------------------------
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return sim::getPin(pin) ? HIGH : LOW; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int mode) { sim::setInterrupt(pin, isr, mode); }
+inline void detachInterrupt(uint8_t pin) { sim::setInterrupt(pin, nullptr, 0); }
+
+inline uint32_t ledcSetup(uint8_t, uint32_t freq, uint8_t) { return freq; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t channel, uint32_t duty) { sim::setPwmDuty(channel, duty); }
+
+// ------------------------------------------------------
+// Random
+// ------------------------------------------------------
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+uint32_t esp_random();  // Hardware RNG on the board; the same LCG here
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+// ------------------------------------------------------
+// Serial
+// ------------------------------------------------------
+class Print {
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        for (size_t i = 0; i < len; i++) write(buf[i]);
+        return len;
+    }
+
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        if ((size_t)n >= sizeof(buf)) n = sizeof(buf) - 1;
+        return write((const uint8_t*)buf, (size_t)n);
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buf, size_t len) override { return fwrite(buf, 1, len, stdout); }
+    int available() override;
+    int read() override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// ------------------------------------------------------
+// ESP object
+// ------------------------------------------------------
+class EspClass {
+public:
+    uint32_t getCycleCount() { return (uint32_t)(sim::nowUs() * 240); }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getFreeHeap() { return 256 * 1024; }
+};
+
+extern EspClass ESP;
+
+inline int64_t esp_timer_get_time() { sim::consumeUs(1); return (int64_t)sim::nowUs(); }
+
+// ------------------------------------------------------
+// FreeRTOS
+// ------------------------------------------------------
+typedef int32_t  BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void*    TaskHandle_t;
+
+struct SimQueue;
+typedef SimQueue* QueueHandle_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define portMAX_DELAY    0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configTICK_RATE_HZ 1000
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m)     ((void)(m))
+#define portEXIT_CRITICAL(m)      ((void)(m))
+#define portENTER_CRITICAL_ISR(m) ((void)(m))
+#define portEXIT_CRITICAL_ISR(m)  ((void)(m))
+#define portYIELD_FROM_ISR(x)     ((void)(x))
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void*), const char* name, uint32_t stackDepth,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks);
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void* item, BaseType_t* higherPriorityTaskWoken);
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks);
+BaseType_t xQueuePeek(QueueHandle_t q, void* item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+BaseType_t xQueueReset(QueueHandle_t q);
+
+// Sketch entry points implemented by the firmware
+void setup();
+void loop();
@@ -0,0 +1,221 @@
+#pragma once
+
+// ======================================================
+// FastLED shim for the native build
+// ======================================================
+// Pixel types and lib8tion math with the same integer semantics as
+// FastLED 3.6 (FASTLED_SCALE8_FIXED), plus a headless FastLED object whose
+// show() only counts frames. Nothing here talks to hardware.
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t fract8;
+
+#define LIB8STATIC inline
+
+// ------------------------------------------------------
+// lib8tion
+// ------------------------------------------------------
+LIB8STATIC uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned t = i + j;
+    return t > 255 ? 255 : (uint8_t)t;
+}
+
+LIB8STATIC uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : (uint8_t)t;
+}
+
+LIB8STATIC uint8_t scale8(uint8_t i, fract8 scale) {
+    return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8);
+}
+
+LIB8STATIC uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (uint8_t)((((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0));
+}
+
+LIB8STATIC uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (uint16_t)((a << 8) | b);
+    partial += (uint16_t)(b * amountOfB);
+    partial -= (uint16_t)(a * amountOfB);
+    return (uint8_t)(partial >> 8);
+}
+
+LIB8STATIC uint16_t scale16(uint16_t i, uint16_t scale) {
+    return (uint16_t)(((uint32_t)i * (1 + (uint32_t)scale)) >> 16);
+}
+
+LIB8STATIC uint8_t sin8(uint8_t theta) {
+    static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+    uint8_t offset = theta;
+    if (theta & 0x40) offset = (uint8_t)255 - offset;
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) secoffset++;
+
+    uint8_t section = offset >> 4;
+    uint8_t b = b_m16_interleave[section * 2];
+    uint8_t m16 = b_m16_interleave[section * 2 + 1];
+    uint8_t mx = (uint8_t)((m16 * secoffset) >> 4);
+
+    int8_t y = (int8_t)(mx + b);
+    if (theta & 0x80) y = -y;
+    y += 128;
+    return (uint8_t)y;
+}
+
+LIB8STATIC uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+LIB8STATIC uint8_t ease8InOutQuad(uint8_t i) {
+    uint8_t j = i;
+    if (j & 0x80) j = 255 - j;
+    uint8_t jj = scale8(j, j);
+    uint8_t jj2 = jj << 1;
+    if (i & 0x80) jj2 = 255 - jj2;
+    return jj2;
+}
+
+extern uint16_t rand16seed;
+
+LIB8STATIC uint8_t random8() {
+    rand16seed = (uint16_t)(rand16seed * 2053 + 13849);
+    return (uint8_t)((uint8_t)(rand16seed & 0xFF) + (uint8_t)(rand16seed >> 8));
+}
+LIB8STATIC uint8_t random8(uint8_t lim) { return (uint8_t)((random8() * lim) >> 8); }
+LIB8STATIC uint8_t random8(uint8_t min, uint8_t lim) { return (uint8_t)(random8(lim - min) + min); }
+LIB8STATIC uint16_t random16() {
+    rand16seed = (uint16_t)(rand16seed * 2053 + 13849);
+    return rand16seed;
+}
+LIB8STATIC void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+
+// ------------------------------------------------------
+// Pixel types
+// ------------------------------------------------------
+struct CRGB;
+
+struct CHSV {
+    union {
+        struct {
+            union { uint8_t hue; uint8_t h; };
+            union { uint8_t saturation; uint8_t sat; uint8_t s; };
+            union { uint8_t value; uint8_t val; uint8_t v; };
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    typedef enum {
+        Black  = 0x000000,
+        Blue   = 0x0000FF,
+        Green  = 0x008000,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Red    = 0xFF0000,
+        White  = 0xFFFFFF,
+        Yellow = 0xFFFF00,
+    } HTMLColorCode;
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    constexpr CRGB(uint32_t colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    constexpr CRGB(HTMLColorCode colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB& operator=(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+    CRGB& operator=(uint32_t colorcode) {
+        r = (colorcode >> 16) & 0xFF; g = (colorcode >> 8) & 0xFF; b = colorcode & 0xFF;
+        return *this;
+    }
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB& operator+=(const CRGB& rhs) {
+        r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b);
+        return *this;
+    }
+    CRGB& operator-=(const CRGB& rhs) {
+        r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scaledown) {
+        r = scale8(r, scaledown); g = scale8(g, scaledown); b = scale8(b, scaledown);
+        return *this;
+    }
+    CRGB& nscale8_video(uint8_t scaledown) {
+        r = scale8_video(r, scaledown); g = scale8_video(g, scaledown); b = scale8_video(b, scaledown);
+        return *this;
+    }
+    CRGB& fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+    CRGB& operator%=(uint8_t scaledown) { return nscale8_video(scaledown); }
+
+    uint8_t getLuma() const { return scale8(r, 54) + scale8(g, 183) + scale8(b, 18); }
+
+    explicit operator bool() const { return r || g || b; }
+};
+
+inline bool operator==(const CRGB& a, const CRGB& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+inline bool operator!=(const CRGB& a, const CRGB& b) { return !(a == b); }
+inline CRGB operator+(const CRGB& a, const CRGB& b) { CRGB t = a; t += b; return t; }
+inline CRGB operator%(const CRGB& p, uint8_t d) { CRGB t = p; t.nscale8_video(d); return t; }
+
+// ------------------------------------------------------
+// Colour utilities
+// ------------------------------------------------------
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color);
+void fadeToBlackBy(CRGB* leds, uint16_t numLeds, uint8_t fadeBy);
+void nscale8(CRGB* leds, uint16_t numLeds, uint8_t scale);
+CRGB& nblend(CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay);
+void nblend(CRGB* existing, const CRGB* overlay, uint16_t count, fract8 amountOfOverlay);
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2);
+CRGB* blend(const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fract8 amountOfsrc2);
+
+// ------------------------------------------------------
+// Controller front-end (headless frame sink)
+// ------------------------------------------------------
+enum ESPIChipsets { WS2812B };
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+class CFastLED {
+public:
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CFastLED& addLeds(CRGB* data, int numLeds) {
+        _leds = data;
+        _numLeds = numLeds;
+        return *this;
+    }
+
+    void show();
+    void setBrightness(uint8_t scale) { _brightness = scale; }
+    uint8_t getBrightness() const { return _brightness; }
+    uint32_t getFrameCount() const { return _frames; }
+
+private:
+    CRGB* _leds = nullptr;
+    int _numLeds = 0;
+    uint8_t _brightness = 255;
+    uint32_t _frames = 0;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,44 @@
+#pragma once
+
+// ======================================================
+// LittleFS shim for the native build
+// ======================================================
+// Read-only view of a host directory standing in for the flash partition:
+// "/effects/comet.fx" opens <root>/effects/comet.fx. The root is "data",
+// the directory PlatformIO uploads with uploadfs, unless the simulation
+// sets another with sim::setFsRoot().
+
+#include <memory>
+#include <string>
+#include "Arduino.h"
+
+struct SimFile;
+
+class File {
+public:
+    File() = default;
+    explicit File(std::shared_ptr<SimFile> file) : _file(file) {}
+
+    explicit operator bool() const;
+    bool isDirectory() const;
+    const char* name() const;   // Base name, as the ESP32 core returns it
+    size_t size() const;
+    size_t read(uint8_t* buf, size_t size);
+    File openNextFile();
+    void close() { _file.reset(); }
+
+private:
+    std::shared_ptr<SimFile> _file;
+};
+
+class LittleFSFS {
+public:
+    bool begin(bool formatOnFail = false);
+    File open(const char* path, const char* mode = "r");
+};
+
+extern LittleFSFS LittleFS;
+
+namespace sim {
+void setFsRoot(const char* dir);
+}
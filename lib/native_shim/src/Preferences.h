@@ -0,0 +1,40 @@
+#pragma once
+
+// ======================================================
+// Preferences (NVS) shim for the native build
+// ======================================================
+// Keeps values in memory for the life of the process, so settings behave
+// as on a freshly erased board: every get returns its default until set.
+
+#include <map>
+#include <string>
+#include "Arduino.h"
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        _ns = name;
+        _readOnly = readOnly;
+        return true;
+    }
+    void end() {}
+
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) {
+        auto it = store()[_ns].find(key);
+        return it == store()[_ns].end() ? defaultValue : (uint16_t)it->second;
+    }
+    size_t putUShort(const char* key, uint16_t value) {
+        if (_readOnly) return 0;
+        store()[_ns][key] = value;
+        return sizeof(value);
+    }
+
+private:
+    static std::map<std::string, std::map<std::string, uint32_t>>& store() {
+        static std::map<std::string, std::map<std::string, uint32_t>> values;
+        return values;
+    }
+
+    std::string _ns;
+    bool _readOnly = false;
+};
@@ -0,0 +1,194 @@
+#include "Arduino.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ======================================================
+// Serial input
+// ======================================================
+static std::string gSerialInput;
+
+void sim::feedSerial(const char* text) {
+    gSerialInput += text;
+}
+
+int HardwareSerial::available() {
+    return (int)gSerialInput.size();
+}
+
+int HardwareSerial::read() {
+    if (gSerialInput.empty()) return -1;
+    int c = (uint8_t)gSerialInput[0];
+    gSerialInput.erase(0, 1);
+    return c;
+}
+
+// ======================================================
+// Time & random
+// ======================================================
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// Same LCG on every host so random() sequences are reproducible
+static uint32_t gRandomState = 1;
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) gRandomState = (uint32_t)seed;
+}
+
+static uint32_t nextRandom() {
+    gRandomState = gRandomState * 1103515245u + 12345u;
+    return (gRandomState >> 1) & 0x7FFFFFFF;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return (long)(nextRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+uint32_t esp_random() {
+    return nextRandom() ^ (nextRandom() << 16);
+}
+
+// ======================================================
+// Tasks
+// ======================================================
+struct TaskNotify {
+    uint32_t count = 0;
+};
+
+static std::vector<std::pair<void*, TaskNotify*>> gNotify;
+
+static TaskNotify* notifyFor(void* task) {
+    for (auto& n : gNotify) {
+        if (n.first == task) return n.second;
+    }
+    gNotify.push_back(std::make_pair(task, new TaskNotify()));
+    return gNotify.back().second;
+}
+
+// Timeouts end on a tick interrupt, as in FreeRTOS: n ticks from now is
+// the n-th 1ms tick boundary after the current tick
+static uint64_t deadlineFor(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return UINT64_MAX;
+    return (sim::nowUs() / 1000 + ticks) * 1000;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        sim::yield();
+        return;
+    }
+    sim::block(nullptr, deadlineFor(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(sim::nowUs() / 1000);
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void*), const char* name, uint32_t stackDepth,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    (void)core;
+    void* t = sim::createTask(fn, name, stackDepth, arg, (int)priority);
+    if (handle) *handle = t;
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return sim::currentTask();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    TaskNotify* n = notifyFor(sim::currentTask());
+    sim::block([n] { return n->count > 0; }, deadlineFor(ticks));
+    uint32_t value = n->count;
+    if (value > 0) n->count = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    notifyFor(task)->count++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    notifyFor(task)->count++;
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+// ======================================================
+// Queues
+// ======================================================
+struct SimQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* q = new SimQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+static bool pushItem(QueueHandle_t q, const void* item) {
+    if (q->items.size() >= q->length) return false;
+    const uint8_t* p = static_cast<const uint8_t*>(item);
+    q->items.push_back(std::vector<uint8_t>(p, p + q->itemSize));
+    return true;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    if (ticks > 0) sim::block([q] { return q->items.size() < q->length; }, deadlineFor(ticks));
+    return pushItem(q, item) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+    return pushItem(q, item) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    if (q->items.empty() && ticks > 0) {
+        sim::block([q] { return !q->items.empty(); }, deadlineFor(ticks));
+    }
+    if (q->items.empty()) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t q, void* item, TickType_t ticks) {
+    if (q->items.empty() && ticks > 0) {
+        sim::block([q] { return !q->items.empty(); }, deadlineFor(ticks));
+    }
+    if (q->items.empty()) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    return (UBaseType_t)q->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    q->items.clear();
+    return pdPASS;
+}
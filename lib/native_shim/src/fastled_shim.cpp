@@ -0,0 +1,108 @@
+#include "FastLED.h"
+#include "sim.h"
+
+uint16_t rand16seed = 1337;
+CFastLED FastLED;
+
+// WS2812B: 24 bits at 800 kHz per LED plus the latch gap
+void CFastLED::show() {
+    _frames++;
+    sim::consumeUs((uint32_t)_numLeds * 30 + 50);
+}
+
+// Port of FastLED's hsv2rgb_rainbow (Y1 yellow boost, no green scaling)
+void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    const uint8_t hue = hsv.hue;
+    const uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset8 = (uint8_t)((hue & 0x1F) << 3);
+    uint8_t third = scale8(offset8, (256 / 3));
+    uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+
+    uint8_t r, g, b;
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) { r = 255 - third; g = third; b = 0; }
+            else               { r = 171; g = 85 + third; b = 0; }
+        } else {
+            if (!(hue & 0x20)) { r = 171 - twothirds; g = 170 + third; b = 0; }
+            else               { r = 0; g = 255 - third; b = third; }
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) { r = 0; g = 171 - twothirds; b = 85 + twothirds; }
+            else               { r = third; g = 0; b = 255 - third; }
+        } else {
+            if (!(hue & 0x20)) { r = 85 + third; g = 0; b = 171 - third; }
+            else               { r = 170 + third; g = 0; b = 85 - third; }
+        }
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = g = b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale) + desat;
+            g = scale8(g, satscale) + desat;
+            b = scale8(b, satscale) + desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = g = b = 0;
+        } else {
+            r = scale8(r, val);
+            g = scale8(g, val);
+            b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+    for (int i = 0; i < numToFill; i++) leds[i] = color;
+}
+
+void fadeToBlackBy(CRGB* leds, uint16_t numLeds, uint8_t fadeBy) {
+    nscale8(leds, numLeds, 255 - fadeBy);
+}
+
+void nscale8(CRGB* leds, uint16_t numLeds, uint8_t scale) {
+    for (uint16_t i = 0; i < numLeds; i++) leds[i].nscale8(scale);
+}
+
+CRGB& nblend(CRGB& existing, const CRGB& overlay, fract8 amountOfOverlay) {
+    if (amountOfOverlay == 0) return existing;
+    if (amountOfOverlay == 255) {
+        existing = overlay;
+        return existing;
+    }
+    existing.r = blend8(existing.r, overlay.r, amountOfOverlay);
+    existing.g = blend8(existing.g, overlay.g, amountOfOverlay);
+    existing.b = blend8(existing.b, overlay.b, amountOfOverlay);
+    return existing;
+}
+
+void nblend(CRGB* existing, const CRGB* overlay, uint16_t count, fract8 amountOfOverlay) {
+    for (uint16_t i = 0; i < count; i++) nblend(existing[i], overlay[i], amountOfOverlay);
+}
+
+CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    CRGB nu(p1);
+    nblend(nu, p2, amountOfP2);
+    return nu;
+}
+
+CRGB* blend(const CRGB* src1, const CRGB* src2, CRGB* dest, uint16_t count, fract8 amountOfsrc2) {
+    for (uint16_t i = 0; i < count; i++) dest[i] = blend(src1[i], src2[i], amountOfsrc2);
+    return dest;
+}
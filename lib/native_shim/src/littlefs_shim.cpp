@@ -0,0 +1,75 @@
+#include "LittleFS.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+LittleFSFS LittleFS;
+
+static std::string gFsRoot = "data";
+
+void sim::setFsRoot(const char* dir) {
+    gFsRoot = dir;
+}
+
+// An open file or directory under the root
+struct SimFile {
+    std::string path;
+    std::string name;
+    FILE* file = nullptr;
+    DIR* dir = nullptr;
+
+    ~SimFile() {
+        if (file) fclose(file);
+        if (dir) closedir(dir);
+    }
+};
+
+static std::shared_ptr<SimFile> openHost(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return nullptr;
+
+    auto f = std::make_shared<SimFile>();
+    f->path = path;
+    size_t slash = path.find_last_of('/');
+    f->name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    if (S_ISDIR(st.st_mode)) {
+        f->dir = opendir(path.c_str());
+    } else {
+        f->file = fopen(path.c_str(), "rb");
+    }
+    return (f->dir || f->file) ? f : nullptr;
+}
+
+File::operator bool() const { return _file != nullptr; }
+bool File::isDirectory() const { return _file && _file->dir; }
+const char* File::name() const { return _file ? _file->name.c_str() : ""; }
+
+size_t File::size() const {
+    struct stat st;
+    if (!_file || !_file->file || stat(_file->path.c_str(), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    return (_file && _file->file) ? fread(buf, 1, size, _file->file) : 0;
+}
+
+File File::openNextFile() {
+    if (!_file || !_file->dir) return File();
+    while (struct dirent* entry = readdir(_file->dir)) {
+        if (entry->d_name[0] == '.') continue;
+        auto next = openHost(_file->path + "/" + entry->d_name);
+        if (next) return File(next);
+    }
+    return File();
+}
+
+bool LittleFSFS::begin(bool formatOnFail) {
+    (void)formatOnFail;
+    return true;
+}
+
+File LittleFSFS::open(const char* path, const char* mode) {
+    (void)mode;
+    return File(openHost(gFsRoot + path));
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+// ======================================================
+// Host Simulation Kernel
+// ======================================================
+// Deterministic stand-in for FreeRTOS on the native build. Every task runs
+// on its own host thread, but only one holds the baton at a time, so the
+// firmware sees a single-core, cooperative RTOS driven by a virtual clock.
+// Time only moves when tasks block (vTaskDelay, queue waits) or read the
+// clock, which lets a match run many times faster than real time while
+// producing the same frame sequence on every run.
+namespace sim {
+
+typedef void (*TaskFn)(void*);
+typedef std::function<bool()> ReadyFn;
+
+// Virtual clock in microseconds since boot
+uint64_t nowUs();
+
+// Charge the running task for work (advances the clock, may preempt)
+void consumeUs(uint32_t us);
+
+// Create a task; returns an opaque handle
+void* createTask(TaskFn fn, const char* name, uint32_t stackDepth, void* arg, int priority);
+
+// Block the running task until ready() is true or the deadline passes.
+// Returns true if ready() became true, false on timeout.
+bool block(const ReadyFn& ready, uint64_t deadlineUs);
+
+// Yield to any other ready task of equal or higher priority
+void yield();
+
+// Currently running task handle
+void* currentTask();
+const char* taskName(void* handle);
+
+// Schedule a callback at an absolute virtual time (stimuli, GPIO edges)
+void at(uint64_t timeUs, std::function<void()> fn);
+
+// Run the kernel until the virtual clock reaches endUs
+void run(uint64_t endUs);
+
+// End the run early, as if endUs had been reached
+void stop();
+
+// Digital input pins driven by the simulation
+void setPin(uint8_t pin, bool level);
+bool getPin(uint8_t pin);
+
+// Interrupt handlers registered through attachInterrupt()
+void setInterrupt(uint8_t pin, void (*isr)(), int mode);
+
+// Bytes returned by Serial.read() on the host
+void feedSerial(const char* text);
+
+// Last PWM duty written per ledc channel
+uint32_t pwmDuty(uint8_t channel);
+void setPwmDuty(uint8_t channel, uint32_t duty);
+
+}  // namespace sim
@@ -0,0 +1,309 @@
+#include "sim.h"
+#include "Arduino.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ======================================================
+// Kernel State
+// ======================================================
+namespace {
+
+// A task is preempted at a clock read once it has run this long while a
+// task of equal priority is ready (FreeRTOS time slice at 1 kHz tick)
+const uint64_t SLICE_US = 1000;
+
+struct Task {
+    sim::TaskFn fn;
+    void* arg;
+    const char* name;
+    int priority;
+    uint32_t stackDepth;
+    std::condition_variable cv;
+    sim::ReadyFn ready;
+    uint64_t deadlineUs;
+    bool blocked;
+    bool finished;
+    uint32_t notifyCount;
+};
+
+struct Timer {
+    uint64_t timeUs;
+    uint64_t seq;
+    std::function<void()> fn;
+};
+
+std::mutex gMutex;
+std::vector<Task*> gTasks;
+Task* gRunning = nullptr;
+uint64_t gNowUs = 0;
+uint64_t gSliceStartUs = 0;
+uint64_t gTimerSeq = 0;
+
+// Constructed on first use so stimuli can be scheduled from static initialisers
+std::vector<Timer>& timers() {
+    static std::vector<Timer> list;
+    return list;
+}
+
+std::map<uint8_t, bool> gPins;
+std::map<uint8_t, void (*)()> gIsrs;
+std::map<uint8_t, uint32_t> gPwm;
+bool gStarted = false;
+bool gStopped = false;
+bool gInIsr = false;
+
+thread_local Task* tSelf = nullptr;
+
+bool isReady(Task* t) {
+    if (t->finished) return false;
+    if (!t->blocked) return true;
+    if (t->ready && t->ready()) return true;
+    return gNowUs >= t->deadlineUs;
+}
+
+// Fire every timer due at or before the current time (in time order)
+void fireTimers() {
+    for (;;) {
+        size_t best = timers().size();
+        for (size_t i = 0; i < timers().size(); i++) {
+            if (timers()[i].timeUs > gNowUs) continue;
+            if (best == timers().size() ||
+                timers()[i].timeUs < timers()[best].timeUs ||
+                (timers()[i].timeUs == timers()[best].timeUs && timers()[i].seq < timers()[best].seq)) {
+                best = i;
+            }
+        }
+        if (best == timers().size()) return;
+        std::function<void()> fn = timers()[best].fn;
+        timers().erase(timers().begin() + best);
+        gInIsr = true;
+        fn();
+        gInIsr = false;
+    }
+}
+
+// Once the run has ended the calling task parks for good
+void parkIfStopped(std::unique_lock<std::mutex>& lock, Task* self) {
+    if (!gStopped || !self) return;
+    self->cv.wait(lock, [] { return false; });
+}
+
+// Choose the highest-priority ready task, rotating among equals starting
+// after `after`. Advances the clock when nothing is ready.
+Task* pickNext(Task* after) {
+    for (;;) {
+        fireTimers();
+
+        Task* best = nullptr;
+        size_t start = 0;
+        for (size_t i = 0; i < gTasks.size(); i++) {
+            if (gTasks[i] == after) start = i + 1;
+        }
+        for (size_t k = 0; k < gTasks.size(); k++) {
+            Task* t = gTasks[(start + k) % gTasks.size()];
+            if (!isReady(t)) continue;
+            if (!best || t->priority > best->priority) best = t;
+        }
+        if (best) return best;
+
+        uint64_t next = UINT64_MAX;
+        for (Task* t : gTasks) {
+            if (!t->finished && t->blocked && t->deadlineUs < next) next = t->deadlineUs;
+        }
+        for (const Timer& tm : timers()) {
+            if (tm.timeUs < next) next = tm.timeUs;
+        }
+        if (next == UINT64_MAX) {
+            fprintf(stderr, "sim: deadlock at %llu us\n", (unsigned long long)gNowUs);
+            fflush(stdout);
+            std::_Exit(2);
+        }
+        gNowUs = next;
+    }
+}
+
+// Hand the baton to `next` and park the calling task until it gets it back
+void switchTo(std::unique_lock<std::mutex>& lock, Task* self, Task* next) {
+    if (next == self) {
+        self->blocked = false;
+        return;
+    }
+    gRunning = next;
+    gSliceStartUs = gNowUs;
+    next->cv.notify_one();
+    self->cv.wait(lock, [self] { return gRunning == self; });
+    self->blocked = false;
+}
+
+void taskEntry(Task* t) {
+    {
+        std::unique_lock<std::mutex> lock(gMutex);
+        t->cv.wait(lock, [t] { return gRunning == t; });
+    }
+    tSelf = t;
+    t->fn(t->arg);
+
+    // Returning from a task function is fatal on FreeRTOS; mirror that
+    std::unique_lock<std::mutex> lock(gMutex);
+    t->finished = true;
+    Task* next = pickNext(t);
+    gRunning = next;
+    next->cv.notify_one();
+}
+
+}  // namespace
+
+// ======================================================
+// Public API
+// ======================================================
+namespace sim {
+
+uint64_t nowUs() {
+    return gNowUs;
+}
+
+void consumeUs(uint32_t us) {
+    if (!gStarted || gInIsr) {
+        gNowUs += us;
+        return;
+    }
+    std::unique_lock<std::mutex> lock(gMutex);
+    gNowUs += us;
+    Task* self = tSelf;
+    if (!self) return;
+
+    bool dueTimer = false;
+    for (const Timer& tm : timers()) {
+        if (tm.timeUs <= gNowUs) dueTimer = true;
+    }
+    if (dueTimer) fireTimers();
+    parkIfStopped(lock, self);
+
+    // Preempt for higher-priority tasks, time-slice among equals
+    for (Task* t : gTasks) {
+        if (t == self || !isReady(t)) continue;
+        if (t->priority > self->priority ||
+            (t->priority == self->priority && gNowUs - gSliceStartUs >= SLICE_US)) {
+            Task* next = pickNext(self);
+            switchTo(lock, self, next);
+            return;
+        }
+    }
+}
+
+void* createTask(TaskFn fn, const char* name, uint32_t stackDepth, void* arg, int priority) {
+    std::unique_lock<std::mutex> lock(gMutex);
+    Task* t = new Task();
+    t->fn = fn;
+    t->arg = arg;
+    t->name = name;
+    t->priority = priority;
+    t->stackDepth = stackDepth;
+    t->deadlineUs = 0;
+    t->blocked = false;
+    t->finished = false;
+    t->notifyCount = 0;
+    gTasks.push_back(t);
+    std::thread(taskEntry, t).detach();
+    return t;
+}
+
+bool block(const ReadyFn& ready, uint64_t deadlineUs) {
+    std::unique_lock<std::mutex> lock(gMutex);
+    Task* self = tSelf;
+    if (!self) {
+        // Called from setup() before the kernel runs: spin the clock
+        while (!(ready && ready()) && gNowUs < deadlineUs) gNowUs = deadlineUs;
+        return ready && ready();
+    }
+    if (ready && ready()) return true;
+
+    self->ready = ready;
+    self->deadlineUs = deadlineUs;
+    self->blocked = true;
+    Task* next = pickNext(self);
+    parkIfStopped(lock, self);
+    switchTo(lock, self, next);
+    self->ready = nullptr;
+    return ready && ready();
+}
+
+void yield() {
+    std::unique_lock<std::mutex> lock(gMutex);
+    Task* self = tSelf;
+    if (!self) return;
+    Task* next = pickNext(self);
+    parkIfStopped(lock, self);
+    switchTo(lock, self, next);
+}
+
+void* currentTask() {
+    return tSelf;
+}
+
+const char* taskName(void* handle) {
+    return handle ? static_cast<Task*>(handle)->name : "setup";
+}
+
+void at(uint64_t timeUs, std::function<void()> fn) {
+    std::unique_lock<std::mutex> lock(gMutex, std::defer_lock);
+    if (!gInIsr) lock.lock();
+    timers().push_back(Timer{timeUs, gTimerSeq++, fn});
+}
+
+void run(uint64_t endUs) {
+    at(endUs, [] { gStopped = true; });
+
+    std::unique_lock<std::mutex> lock(gMutex);
+    gStarted = true;
+    Task* first = pickNext(nullptr);
+    gRunning = first;
+    gSliceStartUs = gNowUs;
+    first->cv.notify_one();
+
+    // The host main thread only watches for the end-of-run marker; the
+    // simulated tasks stay parked, they never return on target either
+    while (!gStopped) {
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lock.lock();
+    }
+}
+
+void stop() {
+    std::unique_lock<std::mutex> lock(gMutex, std::defer_lock);
+    if (!gInIsr) lock.lock();
+    gStopped = true;
+}
+
+void setPin(uint8_t pin, bool level) {
+    bool old = getPin(pin);
+    gPins[pin] = level;
+    auto it = gIsrs.find(pin);
+    if (old != level && it != gIsrs.end() && it->second) it->second();
+}
+
+bool getPin(uint8_t pin) {
+    auto it = gPins.find(pin);
+    return it == gPins.end() ? true : it->second;  // pulled up
+}
+
+void setInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    (void)mode;
+    gIsrs[pin] = isr;
+}
+
+uint32_t pwmDuty(uint8_t channel) {
+    return gPwm[channel];
+}
+
+void setPwmDuty(uint8_t channel, uint32_t duty) {
+    gPwm[channel] = duty;
+}
+
+}  // namespace sim
@@ -0,0 +1,229 @@
+#include "Arduino.h"
+#include "FastLED.h"
+#include "config.h"
+#include "led_output.h"
+#include "button_input.h"
+#include "match_recorder.h"
+#include "animation_bench.h"
+#include "LittleFS.h"
+
+#include <string>
+#include <vector>
+
+// ======================================================
+// Native Simulation Entry Point
+// ======================================================
+// Usage: program [--seconds N] [--press L@ms[:holdMs]] [--press R@ms] [--serial TEXT]
+//                [--record FILE] [--replay FILE] [--fs DIR]
+//
+// Boots the firmware exactly like the ESP32 core does (setup() then loop()
+// on the "loopTask"), runs it against the virtual clock for N seconds and
+// prints a short summary. Presses are scheduled as GPIO edges so they take
+// the same input path as on hardware. Each --serial TEXT is one console
+// line; the exit code is 1 if a "bench" run failed.
+//
+// --record appends every finished match log to FILE. --replay plays back
+// the logs in FILE, binary as recorded or "matchlog" lines captured from a
+// board's console, one after another, and stops after the last one.
+//
+// --fs serves DIR as the LittleFS partition (default "data").
+//
+// Left out of "pio test" builds, where each test suite has its own main().
+#ifndef PIO_UNIT_TESTING
+
+static void loopTask(void* pvParameters) {
+    (void)pvParameters;
+    setup();
+    for (;;) {
+        loop();
+    }
+}
+
+static void schedulePress(const std::string& spec) {
+    // Format: L@1500 or R@2300:120
+    if (spec.size() < 3 || spec[1] != '@') {
+        fprintf(stderr, "bad --press spec: %s\n", spec.c_str());
+        std::exit(1);
+    }
+    uint8_t pin = (spec[0] == 'L' || spec[0] == 'l') ? BUTTON_LEFT_PIN : BUTTON_RIGHT_PIN;
+    unsigned long atMs = 0, holdMs = 80;
+    sscanf(spec.c_str() + 2, "%lu:%lu", &atMs, &holdMs);
+
+    uint64_t downUs = (uint64_t)atMs * 1000;
+    uint64_t upUs = downUs + (uint64_t)holdMs * 1000;
+    sim::at(downUs, [pin] { sim::setPin(pin, BUTTON_ACTIVE_LEVEL == HIGH); });
+    sim::at(upUs, [pin] { sim::setPin(pin, BUTTON_ACTIVE_LEVEL != HIGH); });
+}
+
+// ======================================================
+// Match Record / Replay
+// ======================================================
+struct ReplayMatch {
+    MatchLogHeader header;
+    std::vector<uint32_t> events;
+};
+
+static FILE* gRecordFile = nullptr;
+static std::vector<ReplayMatch> gReplay;
+static size_t gReplayNext = 0;
+static bool gReplayArmed = false;  // Next match to start is gReplay[gReplayNext - 1]
+static unsigned gReplayDone = 0;
+static unsigned gReplayMismatches = 0;
+
+// Parse one log from bytes; returns bytes used, 0 if there is no valid log
+static size_t parseLog(const uint8_t* data, size_t len, ReplayMatch& match) {
+    if (len < sizeof(MatchLogHeader)) return 0;
+    memcpy(&match.header, data, sizeof(MatchLogHeader));
+    if (match.header.magic != MATCH_LOG_MAGIC || match.header.version != MATCH_LOG_VERSION) return 0;
+
+    size_t eventBytes = match.header.eventCount * sizeof(uint32_t);
+    if (len < sizeof(MatchLogHeader) + eventBytes) return 0;
+    match.events.resize(match.header.eventCount);
+    memcpy(match.events.data(), data + sizeof(MatchLogHeader), eventBytes);
+    return sizeof(MatchLogHeader) + eventBytes;
+}
+
+static void loadLogs(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", path);
+        std::exit(1);
+    }
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+
+    // Console captures: turn every "matchlog <hex>" line into binary first
+    const std::string marker = "matchlog ";
+    std::string text(data.begin(), data.end());
+    if (text.find(marker) != std::string::npos) {
+        data.clear();
+        for (size_t at = text.find(marker); at != std::string::npos; at = text.find(marker, at)) {
+            at += marker.size();
+            while (at + 1 < text.size() && isxdigit(text[at]) && isxdigit(text[at + 1])) {
+                data.push_back((uint8_t)std::stoul(text.substr(at, 2), nullptr, 16));
+                at += 2;
+            }
+        }
+    }
+
+    size_t at = 0;
+    ReplayMatch match;
+    while (size_t used = parseLog(data.data() + at, data.size() - at, match)) {
+        gReplay.push_back(match);
+        at += used;
+    }
+    if (gReplay.empty()) {
+        fprintf(stderr, "no match logs in %s\n", path);
+        std::exit(1);
+    }
+}
+
+// Queue match i's settings and press start at its recorded time, or at
+// notBeforeUs if that has passed. The match presses follow from
+// onMatchStart(), once the game has picked its own start moment.
+static void scheduleMatch(size_t i, uint64_t notBeforeUs) {
+    const ReplayMatch& m = gReplay[i];
+    uint64_t pressUs = m.header.startUs > notBeforeUs ? m.header.startUs : notBeforeUs;
+
+    MatchRecorder::replayNext({m.header.seed, m.header.stripLength, m.header.ballsPerServe});
+    gReplayArmed = true;
+    sim::at(pressUs, [pressUs] { ButtonInput::inject(ButtonEvent{PLAYER_LEFT, true, (uint32_t)pressUs}); });
+}
+
+// Called by the game task as each match begins: replay the presses at the
+// same offsets from the start as recorded. Presses that were already
+// queued when the original began go in at once with their old timestamps.
+static void onMatchStart(const MatchLogHeader& header, const uint32_t* events) {
+    (void)events;
+    if (!gReplayArmed) return;
+    gReplayArmed = false;
+
+    uint64_t nowUs = sim::nowUs();
+    uint64_t startUs = nowUs - (uint32_t)((uint32_t)nowUs - header.startUs);
+    for (uint32_t packed : gReplay[gReplayNext - 1].events) {
+        ButtonEvent ev = unpackMatchEvent(packed, header.startUs);
+        int64_t atUs = (int64_t)startUs + matchEventOffsetUs(packed);
+        sim::at(atUs > (int64_t)nowUs ? (uint64_t)atUs : nowUs, [ev] { ButtonInput::inject(ev); });
+    }
+}
+
+// Called by the game task as each match ends
+static void onMatchEnd(const MatchLogHeader& header, const uint32_t* events) {
+    if (gRecordFile) {
+        fwrite(&header, sizeof(header), 1, gRecordFile);
+        fwrite(events, sizeof(uint32_t), header.eventCount, gRecordFile);
+        fflush(gRecordFile);
+    }
+    if (gReplayNext == 0) return;
+
+    const MatchLogHeader& expected = gReplay[gReplayNext - 1].header;
+    bool same = header.scoreLeft == expected.scoreLeft && header.scoreRight == expected.scoreRight &&
+                header.frameHash == expected.frameHash;
+    gReplayDone++;
+    if (!same) gReplayMismatches++;
+    printf("{\"replay\":%u,\"score\":\"%u-%u\",\"recorded\":\"%u-%u\",\"frames_match\":%s}\n",
+           gReplayDone, header.scoreLeft, header.scoreRight, expected.scoreLeft,
+           expected.scoreRight, header.frameHash == expected.frameHash ? "true" : "false");
+
+    if (gReplayNext < gReplay.size()) {
+        scheduleMatch(gReplayNext++, sim::nowUs() + 1000);
+    } else {
+        sim::stop();
+    }
+}
+
+int main(int argc, char** argv) {
+    double seconds = 30.0;
+    bool secondsGiven = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+            secondsGiven = true;
+        } else if (arg == "--press" && i + 1 < argc) {
+            schedulePress(argv[++i]);
+        } else if (arg == "--serial" && i + 1 < argc) {
+            sim::feedSerial(argv[++i]);
+            sim::feedSerial("\n");
+        } else if (arg == "--record" && i + 1 < argc) {
+            gRecordFile = fopen(argv[++i], "ab");
+            if (!gRecordFile) {
+                fprintf(stderr, "cannot open %s\n", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--replay" && i + 1 < argc) {
+            loadLogs(argv[++i]);
+        } else if (arg == "--fs" && i + 1 < argc) {
+            sim::setFsRoot(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--press L@ms[:holdMs]] [--serial TEXT] "
+                            "[--record FILE] [--replay FILE] [--fs DIR]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    MatchRecorder::setListeners(onMatchStart, onMatchEnd);
+    if (!gReplay.empty()) {
+        // Run until the last replay ends unless told otherwise
+        if (!secondsGiven) seconds = 1e9;
+        scheduleMatch(gReplayNext++, 0);
+    }
+
+    xTaskCreatePinnedToCore(loopTask, "loopTask", 8192, NULL, 1, NULL, 1);
+    sim::run((uint64_t)(seconds * 1e6));
+
+    printf("\n[sim] %.3f s simulated, %u frames shown, %u wire errors\n", sim::nowUs() / 1e6,
+           LedOutput::frameCount(), LedOutput::wireErrors());
+    if (!gReplay.empty()) {
+        printf("[sim] %u of %u matches replayed, %u differ from the recording\n",
+               gReplayDone, (unsigned)gReplay.size(), gReplayMismatches);
+    }
+    fflush(stdout);
+    std::_Exit(AnimationBench::failures() > 0 ? 1 : 0);
+}
+
+#endif
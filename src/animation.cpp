@@ -1,61 +1,213 @@
 #include "animation.h"
+#include "animation_list.h"
+#include "frame_kernels.h"
+#include "led_output.h"
+#include "perf_counters.h"
 
 // ======================================================
 // Animation Base Class Implementation
 // ======================================================
-Animation::Animation(const char* name) : _name(name) {
-    AnimationManager::getInstance().registerAnimation(this);
-}
+uint32_t Animation::_timeMs = 0;
+uint16_t Animation::_length = NUM_LEDS_DEFAULT;
+
+Animation::Animation(const char* name) : _name(name) {}
 
 // ======================================================
 // Animation Manager Implementation
 // ======================================================
-AnimationManager& AnimationManager::getInstance() {
-    static AnimationManager instance;
-    return instance;
+AnimationManager AnimationManager::_instance;
+
+bool AnimationManager::registerAnimation(const AnimationEntry* entry) {
+    if (getCount() >= MAX_ANIMATIONS) return false;
+    _added[_addedCount++] = entry;
+    return true;
 }
 
-void AnimationManager::registerAnimation(Animation* animation) {
-    if (_count < MAX_ANIMATIONS) {
-        _animations[_count++] = animation;
-    }
+uint8_t AnimationManager::getCount() const {
+    return BuiltinAnimations::count + _addedCount;
+}
+
+// Built-in animations first, then the registered ones
+const AnimationEntry* AnimationManager::entry(uint8_t index) const {
+    if (index < BuiltinAnimations::count) return BuiltinAnimations::entries[index];
+    return _added[index - BuiltinAnimations::count];
 }
 
-Animation* AnimationManager::getAnimation(uint8_t index) const {
-    if (index < _count) {
-        return _animations[index];
+const char* AnimationManager::getName(uint8_t index) const {
+    if (index < getCount()) {
+        return entry(index)->name;
     }
     return nullptr;
 }
 
-void AnimationManager::update(CRGB* leds, uint8_t numLeds) {
-    if (_count == 0) return;
+uint16_t AnimationManager::largestSize() const {
+    uint16_t largest = 0;
+    for (uint8_t i = 0; i < getCount(); i++) {
+        largest = max(largest, entry(i)->size);
+    }
+    return largest;
+}
 
-    // Initialize start time on first call
-    if (_startTime == 0) {
-        _startTime = millis();
-        _animations[_currentIndex]->reset();
+// ======================================================
+// Animation Arena
+// ======================================================
+Animation* AnimationManager::load(uint8_t slot, uint8_t index) {
+    unloadSlot(slot);
+    if (index >= getCount()) return nullptr;
+    const AnimationEntry* e = entry(index);
+    _slots[slot].anim = e->create(_slots[slot].storage, e->context);
+    _slots[slot].anim->seed(Rng::stream(RNG_STREAM_ANIMATION + index));
+    return _slots[slot].anim;
+}
+
+void AnimationManager::unloadSlot(uint8_t slot) {
+    if (_slots[slot].anim) {
+        _slots[slot].anim->~Animation();
+        _slots[slot].anim = nullptr;
+    }
+}
+
+void AnimationManager::unload() {
+    unloadSlot(0);
+    unloadSlot(1);
+    _fading = false;
+    _startTime = 0;
+}
+
+bool AnimationManager::update(CRGB* leds, uint16_t numLeds) {
+    if (getCount() == 0) return false;
+    uint32_t now = millis();
+    uint32_t startUs = micros();
+    Animation::setTime(now);
+
+    // Initialize start time on first call or after the strip was resized
+    if (_startTime == 0 || numLeds != _numLeds) {
+        unload();
+        _numLeds = numLeds;
+        Animation::setLength(numLeds);
+        _startTime = now;
+        start(_currentIndex, now);
     }
 
     // Check if it's time to switch animations
-    if (millis() - _startTime >= ANIMATION_DURATION_MS) {
+    if (!_fading && now - _startTime >= ANIMATION_DURATION_MS) {
         next();
     }
 
-    // Update current animation
-    _animations[_currentIndex]->update(leds, numLeds);
+    bool changed = renderSlot(_slots[_active], numLeds, now);
+    if (_fading) {
+        return updateFade(leds, numLeds, now, startUs, changed);
+    }
+
+    // Only changed frames go to the strip
+    if (!changed) return false;
+    memcpy(leds, _slots[_active].frame, sizeof(CRGB) * numLeds);
+    LedOutput::show();
+    return true;
+}
+
+uint32_t AnimationManager::msUntilNextFrame() const {
+    if (getCount() == 0) return ANIMATION_DURATION_MS;
+    if (_startTime == 0) return 0;  // Nothing loaded: start on the next update()
+    uint32_t now = millis();
+
+    int32_t wait = (int32_t)(_slots[_active].nextFrameMs - now);
+    if (_fading) {
+        wait = min(wait, (int32_t)(_slots[_active ^ 1].nextFrameMs - now));
+        wait = min(wait, (int32_t)(_nextBlendMs - now));
+        wait = min(wait, (int32_t)(_fadeStartMs + ANIMATION_FADE_MS - now));
+    } else {
+        wait = min(wait, (int32_t)(_startTime + ANIMATION_DURATION_MS - now));
+    }
+    return wait > 0 ? (uint32_t)wait : 0;
 }
 
 void AnimationManager::next() {
-    _currentIndex = (_currentIndex + 1) % _count;
-    _startTime = millis();
-    _animations[_currentIndex]->reset();
+    _currentIndex = (_currentIndex + 1) % getCount();
+    uint32_t now = millis();
+    _startTime = now;
+    Animation::setTime(now);
+
+    // The outgoing animation keeps running in the other slot while the
+    // incoming one fades in; a fade already under way loses its outgoing side
+    _active ^= 1;
+    _fading = true;
+    _fadeStartMs = now;
+    _nextBlendMs = now;
+    _fadeWorstUs = 0;
+    start(_currentIndex, now);
 }
 
+// The first animation starts on the next update(), at that call's length
 void AnimationManager::resetToFirst() {
+    unload();
     _currentIndex = 0;
-    _startTime = millis();
-    if (_count > 0) {
-        _animations[_currentIndex]->reset();
+}
+
+// Construct an animation in the active slot and start it on a blank frame
+void AnimationManager::start(uint8_t index, uint32_t now) {
+    Slot& slot = _slots[_active];
+    load(_active, index);
+    slot.nextFrameMs = now;
+    fill_solid(slot.frame, MAX_NUM_LEDS, CRGB::Black);
+    slot.anim->reset();
+}
+
+// Render a slot's animation if its next frame is due
+// Returns true if the slot's frame changed
+bool AnimationManager::renderSlot(Slot& slot, uint16_t numLeds, uint32_t now) {
+    if ((int32_t)(now - slot.nextFrameMs) < 0) return false;
+
+    bool changed = slot.anim->update(slot.frame, numLeds);
+
+    // Hold a steady cadence, but resync rather than burst after a stall
+    slot.nextFrameMs += slot.anim->frameIntervalMs();
+    if ((int32_t)(now - slot.nextFrameMs) >= 0) {
+        slot.nextFrameMs = now + slot.anim->frameIntervalMs();
     }
+    return changed;
+}
+
+// ======================================================
+// Cross-Fade
+// ======================================================
+// Both animations run at their own frame rates; the blend is refreshed
+// whenever either changes and at least every ANIMATION_FADE_STEP_MS. A fade
+// frame that overruns ANIMATION_FADE_BUDGET_US ends the fade, so the cost
+// of running two animations at once stays bounded.
+bool AnimationManager::updateFade(CRGB* leds, uint16_t numLeds, uint32_t now,
+                                  uint32_t startUs, bool changed) {
+    Slot& incoming = _slots[_active];
+    Slot& outgoing = _slots[_active ^ 1];
+
+    uint32_t elapsed = now - _fadeStartMs;
+    bool overBudget = _fadeWorstUs > ANIMATION_FADE_BUDGET_US;
+    if (elapsed >= ANIMATION_FADE_MS || overBudget) {
+        _fading = false;
+        unloadSlot(_active ^ 1);
+        PerfCounters::sample(PERF_FADE_US, _fadeWorstUs);
+        if (overBudget) {
+            Serial.printf("Fade to %s cut short: frame took %lu us\n", incoming.anim->getName(),
+                          (unsigned long)_fadeWorstUs);
+        }
+        memcpy(leds, incoming.frame, sizeof(CRGB) * numLeds);
+        LedOutput::show();
+        return true;
+    }
+
+    if (renderSlot(outgoing, numLeds, now)) changed = true;
+    if ((int32_t)(now - _nextBlendMs) >= 0) {
+        _nextBlendMs = now + ANIMATION_FADE_STEP_MS;
+        changed = true;
+    }
+    if (!changed) return false;
+
+    uint8_t amount = elapsed * 255 / ANIMATION_FADE_MS;
+    FrameKernels::blend(leds, outgoing.frame, incoming.frame, numLeds, amount);
+
+    uint32_t costUs = micros() - startUs;
+    if (costUs > _fadeWorstUs) _fadeWorstUs = costUs;
+
+    LedOutput::show();
+    return true;
 }
@@ -0,0 +1,235 @@
+#include "animation_bench.h"
+#include "animation.h"
+#include "frame_kernels.h"
+#include <algorithm>
+
+// ======================================================
+// CPU Clock
+// ======================================================
+#ifdef ARDUINO_ARCH_ESP32
+
+static inline uint32_t benchTicks() { return ESP.getCycleCount(); }
+static inline float ticksToUs(uint32_t ticks) { return (float)ticks / ESP.getCpuFreqMHz(); }
+
+#else
+
+#include <chrono>
+
+// Host wall clock in ns; the simulated micros() would not see CPU cost
+static inline uint32_t benchTicks() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline float ticksToUs(uint32_t ticks) { return ticks / 1000.0f; }
+
+#endif
+
+// Strip lengths timed for each animation and kernel
+static const uint16_t BENCH_LED_COUNTS[] = {NUM_LEDS_DEFAULT, 150, 300, MAX_NUM_LEDS};
+static const uint8_t BENCH_LED_COUNT_NUM = sizeof(BENCH_LED_COUNTS) / sizeof(BENCH_LED_COUNTS[0]);
+
+static CRGB benchLeds[MAX_NUM_LEDS];
+static uint32_t benchFrameTicks[BENCH_FRAMES];  // One run's frame times, for the percentile
+static CRGB benchScratch[2][MAX_NUM_LEDS];  // Kernel inputs and wire output
+
+// The effect program under test runs here, beside the native animation in
+// the manager's first slot
+alignas(ANIMATION_SLOT_ALIGN) static uint8_t benchEffectSlot[sizeof(EffectAnimation)];
+
+// ======================================================
+// Benchmark
+// ======================================================
+uint16_t AnimationBench::_failures = 0;
+
+bool AnimationBench::run(Print& out) {
+    AnimationManager& manager = AnimationManager::getInstance();
+
+    // Each run gets a freshly constructed instance in the first arena slot
+    manager.unload();
+
+    uint16_t runs = 0;
+    uint16_t failures = 0;
+    for (uint8_t i = 0; i < manager.getCount(); i++) {
+        for (uint8_t n = 0; n < BENCH_LED_COUNT_NUM; n++) {
+            if (!runOne(out, i, BENCH_LED_COUNTS[n])) failures++;
+            runs++;
+        }
+    }
+    for (uint8_t e = 0; e < EffectLibrary::builtinCount(); e++) {
+        for (uint8_t n = 0; n < BENCH_LED_COUNT_NUM; n++) {
+            if (!runEffect(out, EffectLibrary::builtins()[e], BENCH_LED_COUNTS[n])) failures++;
+            runs++;
+        }
+    }
+    manager.unload();
+
+    for (uint8_t n = 0; n < BENCH_LED_COUNT_NUM; n++) {
+        runKernels(out, BENCH_LED_COUNTS[n]);
+    }
+
+    out.printf("{\"bench\":\"summary\",\"runs\":%u,\"failures\":%u,\"pass\":%s}\n",
+               runs, failures, failures == 0 ? "true" : "false");
+    _failures += failures;
+    return failures == 0;
+}
+
+bool AnimationBench::runOne(Print& out, uint8_t index, uint16_t numLeds) {
+    Animation* anim = AnimationManager::getInstance().load(0, index);
+
+    fill_solid(benchLeds, MAX_NUM_LEDS, CRGB::Black);
+    uint32_t timeMs = 0;
+    Animation::setTime(timeMs);
+    Animation::setLength(numLeds);
+    anim->reset();
+
+    uint64_t totalTicks = 0;
+    uint16_t drawn = 0;
+    for (uint16_t f = 0; f < BENCH_FRAMES; f++) {
+        Animation::setTime(timeMs);
+
+        uint32_t start = benchTicks();
+        bool changed = anim->update(benchLeds, numLeds);
+        uint32_t ticks = benchTicks() - start;
+
+        totalTicks += ticks;
+        benchFrameTicks[f] = ticks;
+        if (changed) drawn++;
+        timeMs += anim->frameIntervalMs();
+    }
+
+    // The gate is the 99th percentile frame: the single worst one also
+    // catches whatever preempted the bench (the output task, an interrupt,
+    // the host scheduler), so it is only reported
+    const uint16_t p99Index = (BENCH_FRAMES * 99 + 99) / 100 - 1;
+    std::nth_element(benchFrameTicks, benchFrameTicks + p99Index, benchFrameTicks + BENCH_FRAMES);
+    float p99Us = ticksToUs(benchFrameTicks[p99Index]);
+    float maxUs = ticksToUs(*std::max_element(benchFrameTicks + p99Index, benchFrameTicks + BENCH_FRAMES));
+    float meanUs = ticksToUs(totalTicks / BENCH_FRAMES);
+    bool pass = p99Us <= BENCH_FRAME_BUDGET_US;
+
+    out.printf("{\"bench\":\"frame\",\"anim\":\"%s\",\"leds\":%u,\"frames\":%u,\"drawn\":%u,"
+               "\"mean_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f,\"budget_us\":%u,\"pass\":%s}\n",
+               anim->getName(), numLeds, BENCH_FRAMES, drawn, meanUs, p99Us, maxUs,
+               BENCH_FRAME_BUDGET_US, pass ? "true" : "false");
+    return pass;
+}
+
+// ======================================================
+// Effect Program Benchmark
+// ======================================================
+// Start an animation as the manager would, on a blank frame at time 0
+static void benchStart(Animation* anim, CRGB* leds, uint16_t numLeds) {
+    fill_solid(leds, MAX_NUM_LEDS, CRGB::Black);
+    Animation::setTime(0);
+    Animation::setLength(numLeds);
+    anim->reset();
+}
+
+// Mean frame time over BENCH_FRAMES, timed as one block so the clock's own
+// cost does not swamp animations that take well under a microsecond. The
+// best of three blocks is kept, as the least disturbed by anything else.
+static float benchMeanUs(Animation* anim, CRGB* leds, uint16_t numLeds) {
+    uint32_t best = UINT32_MAX;
+    for (uint8_t run = 0; run < 3; run++) {
+        benchStart(anim, leds, numLeds);
+        uint32_t timeMs = 0;
+        uint32_t start = benchTicks();
+        for (uint16_t f = 0; f < BENCH_FRAMES; f++) {
+            Animation::setTime(timeMs);
+            anim->update(leds, numLeds);
+            timeMs += anim->frameIntervalMs();
+        }
+        best = min(best, benchTicks() - start);
+    }
+    return ticksToUs(best / BENCH_FRAMES);
+}
+
+bool AnimationBench::runEffect(Print& out, const EffectSource& source, uint16_t numLeds) {
+    AnimationManager& manager = AnimationManager::getInstance();
+    uint8_t index = 0;
+    while (index < manager.getCount() && strcmp(manager.getName(index), source.name) != 0) index++;
+    if (index == manager.getCount()) return true;  // Original not built in
+    if (!effectProgramValid(source.code, source.length)) {
+        out.printf("{\"bench\":\"effect\",\"anim\":\"%s\",\"leds\":%u,\"valid\":false,\"pass\":false}\n",
+                   source.name, numLeds);
+        return false;
+    }
+
+    Animation* native = manager.load(0, index);
+    Animation* program = new (benchEffectSlot) EffectAnimation(source.name, source.code, source.length);
+    program->seed(Rng::stream(RNG_STREAM_ANIMATION + index));
+
+    float nativeUs = benchMeanUs(native, benchLeds, numLeds);
+    float programUs = benchMeanUs(program, benchScratch[0], numLeds);
+
+    // Then render both again side by side and compare every frame
+    native = manager.load(0, index);
+    program->~Animation();
+    program = new (benchEffectSlot) EffectAnimation(source.name, source.code, source.length);
+    program->seed(Rng::stream(RNG_STREAM_ANIMATION + index));
+    benchStart(native, benchLeds, numLeds);
+    benchStart(program, benchScratch[0], numLeds);
+    bool same = true;
+    uint32_t timeMs = 0;
+    for (uint16_t f = 0; f < BENCH_FRAMES && same; f++) {
+        Animation::setTime(timeMs);
+        native->update(benchLeds, numLeds);
+        program->update(benchScratch[0], numLeds);
+        same = memcmp(benchLeds, benchScratch[0], sizeof(CRGB) * numLeds) == 0;
+        timeMs += native->frameIntervalMs();
+    }
+    program->~Animation();
+
+    float ratio = nativeUs > 0 ? programUs / nativeUs : 1.0f;
+    bool pass = same && ratio <= BENCH_EFFECT_MAX_RATIO;
+    out.printf("{\"bench\":\"effect\",\"anim\":\"%s\",\"leds\":%u,\"frames\":%u,"
+               "\"native_us\":%.2f,\"program_us\":%.2f,\"ratio\":%.2f,\"max_ratio\":%.2f,"
+               "\"same_frames\":%s,\"pass\":%s}\n",
+               source.name, numLeds, BENCH_FRAMES, nativeUs, programUs, ratio,
+               BENCH_EFFECT_MAX_RATIO, same ? "true" : "false", pass ? "true" : "false");
+    return pass;
+}
+
+// ======================================================
+// Kernel Benchmark
+// ======================================================
+// Per-call time over BENCH_FRAMES calls, best of three blocks as for the
+// effect programs: a single block is at the mercy of one interrupt
+template<typename Kernel>
+static float benchKernelUs(Kernel kernel) {
+    uint32_t best = UINT32_MAX;
+    for (uint8_t run = 0; run < 3; run++) {
+        uint32_t start = benchTicks();
+        for (uint16_t f = 0; f < BENCH_FRAMES; f++) {
+            kernel(f);
+        }
+        best = min(best, benchTicks() - start);
+    }
+    return ticksToUs(best / BENCH_FRAMES);
+}
+
+// Time the per-frame kernels, and the blend through its runtime-length
+// fallback too, so the gain of the fixed-length copies shows against strip
+// length
+void AnimationBench::runKernels(Print& out, uint16_t numLeds) {
+    for (uint16_t i = 0; i < numLeds; i++) {
+        benchScratch[0][i] = CHSV(i * 7, 255, 255);
+        benchScratch[1][i] = CHSV(i * 3, 200, 128);
+    }
+    uint8_t* wire = benchScratch[1][0].raw;
+
+    float encodeUs = benchKernelUs([&](uint16_t) {
+        FrameKernels::encode(wire, benchScratch[0], numLeds, BRIGHTNESS);
+    });
+    float blendUs = benchKernelUs([&](uint16_t f) {
+        FrameKernels::blend(benchLeds, benchScratch[0], benchScratch[1], numLeds, f);
+    });
+    float blendGenericUs = benchKernelUs([&](uint16_t f) {
+        FrameKernels::blendGeneric(benchLeds, benchScratch[0], benchScratch[1], numLeds, f);
+    });
+
+    out.printf("{\"bench\":\"kernel\",\"leds\":%u,\"specialised\":%s,"
+               "\"encode_us\":%.2f,\"blend_us\":%.2f,\"blend_generic_us\":%.2f}\n",
+               numLeds, FrameKernels::isSpecialised(numLeds) ? "true" : "false",
+               encodeUs, blendUs, blendGenericUs);
+}
@@ -1,4 +1,9 @@
 #include "animation.h"
+#include "fixed_point.h"
+
+static constexpr Q16_16 GRAVITY = Q16_16::fromFloat(0.15f);  // LEDs per frame per frame
+static constexpr Q16_16 DAMPING = Q16_16::fromFloat(0.75f);  // Speed kept after a bounce
+static constexpr Q16_16 SETTLED = Q16_16::fromFloat(0.5f);   // Slower than this stops at the ground
 
 class BouncingBallsAnimation : public Animation {
 public:
@@ -9,18 +14,19 @@ public:
 
         // Initialize balls at different starting positions
         for (int i = 0; i < NUM_BALLS; i++) {
-            _ballPos[i] = random(5, NUM_LEDS - 5);
-            _ballVel[i] = 0;
-            _ballGround[i] = (i % 2 == 0) ? 0 : NUM_LEDS - 1;  // Alternate ground sides
+            _ballPos[i] = Q16_16::fromInt(rng().range(5, stripLength() - 5));
+            _ballVel[i] = Q16_16();
+            _ballGround[i] = (i % 2 == 0) ? 0 : stripLength() - 1;  // Alternate ground sides
             _ballColor[i] = CHSV(i * 60 + 20, 255, 255);  // Different colors
-            _timeSinceKick[i] = random(0, 3000);  // Stagger initial kicks
+            _timeSinceKick[i] = rng().below(3000);  // Stagger initial kicks
         }
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 20) return;
-        uint32_t deltaTime = millis() - _lastUpdate;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 20; }
+
+    bool update(CRGB* leds, uint16_t numLeds) override {
+        uint32_t deltaTime = timeMs() - _lastUpdate;
+        _lastUpdate = timeMs();
 
         // Clear with fade for trail effect
         for (int i = 0; i < numLeds; i++) {
@@ -28,11 +34,12 @@ public:
         }
 
         // Update each ball
+        const Q16_16 top = Q16_16::fromInt(numLeds - 1);
         for (int b = 0; b < NUM_BALLS; b++) {
             _timeSinceKick[b] += deltaTime;
 
             // Gravity pulls toward the ball's ground
-            float gravity = (_ballGround[b] == 0) ? -0.15f : 0.15f;
+            Q16_16 gravity = (_ballGround[b] == 0) ? -GRAVITY : GRAVITY;
 
             // Apply gravity
             _ballVel[b] += gravity;
@@ -41,36 +48,36 @@ public:
             _ballPos[b] += _ballVel[b];
 
             // Bounce off ground
-            if (_ballGround[b] == 0 && _ballPos[b] <= 0) {
-                _ballPos[b] = 0;
+            if (_ballGround[b] == 0 && _ballPos[b] <= Q16_16()) {
+                _ballPos[b] = Q16_16();
                 _ballVel[b] = -_ballVel[b] * DAMPING;
 
                 // Re-kick if ball has settled
-                if (abs(_ballVel[b]) < 0.5f) {
-                    _ballVel[b] = 0;
+                if (_ballVel[b].abs() < SETTLED) {
+                    _ballVel[b] = Q16_16();
                 }
-            } else if (_ballGround[b] == numLeds - 1 && _ballPos[b] >= numLeds - 1) {
-                _ballPos[b] = numLeds - 1;
+            } else if (_ballGround[b] == numLeds - 1 && _ballPos[b] >= top) {
+                _ballPos[b] = top;
                 _ballVel[b] = -_ballVel[b] * DAMPING;
 
-                if (abs(_ballVel[b]) < 0.5f) {
-                    _ballVel[b] = 0;
+                if (_ballVel[b].abs() < SETTLED) {
+                    _ballVel[b] = Q16_16();
                 }
             }
 
             // Periodically kick the ball back up
-            if (_timeSinceKick[b] > 2500 + random(0, 1500) && abs(_ballVel[b]) < 1.0f) {
-                float kickStrength = 3.5f + random(0, 20) / 10.0f;
+            if (_timeSinceKick[b] > 2500 + rng().below(1500) && _ballVel[b].abs() < Q16_16::fromInt(1)) {
+                Q16_16 kickStrength = Q16_16::fromRatio(35 + rng().below(20), 10);
                 _ballVel[b] = (_ballGround[b] == 0) ? kickStrength : -kickStrength;
                 _timeSinceKick[b] = 0;
             }
 
             // Clamp position
-            if (_ballPos[b] < 0) _ballPos[b] = 0;
-            if (_ballPos[b] >= numLeds) _ballPos[b] = numLeds - 1;
+            if (_ballPos[b] < Q16_16()) _ballPos[b] = Q16_16();
+            if (_ballPos[b] >= Q16_16::fromInt(numLeds)) _ballPos[b] = top;
 
             // Draw ball with small glow
-            int pos = (int)_ballPos[b];
+            int pos = _ballPos[b].toInt();
             leds[pos] = _ballColor[b];
 
             // Subtle glow around ball
@@ -78,15 +85,14 @@ public:
             if (pos < numLeds - 1) leds[pos + 1] += _ballColor[b] % 64;
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
     static const int NUM_BALLS = 4;
-    static constexpr float DAMPING = 0.75f;
 
-    float _ballPos[NUM_BALLS];
-    float _ballVel[NUM_BALLS];
+    Q16_16 _ballPos[NUM_BALLS];
+    Q16_16 _ballVel[NUM_BALLS];
     int _ballGround[NUM_BALLS];
     CRGB _ballColor[NUM_BALLS];
     uint32_t _timeSinceKick[NUM_BALLS];
@@ -5,15 +5,13 @@ public:
     ColorBreathingAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         _phase = 0;
         _currentHue = 0;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 20) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 20; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         _phase++;
 
         // Slow breathing cycle (~4 seconds per breath)
@@ -43,11 +41,10 @@ public:
             leds[i] = CHSV(_currentHue + hueOffset, 220, brightness);
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
-    uint32_t _lastUpdate = 0;
     uint8_t _phase = 0;
     uint8_t _currentHue = 0;
     uint8_t _lastBreathPhase = 0;
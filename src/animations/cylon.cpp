@@ -8,15 +8,13 @@ public:
     }
 
     void reset() override {
-        _pos = NUM_LEDS / 2;
+        _pos = stripLength() / 2;
         _dir = 1;
-        _lastUpdate = 0;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 55) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 55; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         fill_solid(leds, numLeds, CRGB::Black);
 
         const uint8_t maxBright = 255;
@@ -40,13 +38,12 @@ public:
         }
 
         _pos += _dir;
-        FastLED.show();
+        return true;
     }
 
 private:
-    int _pos = NUM_LEDS / 2;
+    int _pos = 0;
     int _dir = 1;
-    uint32_t _lastUpdate = 0;
     uint8_t _intensity[13];  // Pre-calculated Gaussian weights
 
     void initGaussian() {
@@ -1,24 +1,28 @@
 #include "animation.h"
+#include "fixed_point.h"
+
+static constexpr Q16_16 APPROACH_ACCEL = Q16_16::fromFloat(0.05f);  // LEDs per frame per frame
+static constexpr Q16_16 RETREAT_DECEL  = Q16_16::fromFloat(0.03f);
+static constexpr Q16_16 APPROACH_MAX   = Q16_16::fromFloat(2.5f);
+static constexpr Q16_16 RETREAT_MIN    = Q16_16::fromFloat(0.5f);
 
 class DuelChaseAnimation : public Animation {
 public:
     DuelChaseAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
-        _leftPos = 0;
-        _rightPos = NUM_LEDS - 1;
-        _leftSpeed = 1.0f;
-        _rightSpeed = 1.0f;
+        _leftPos = Q16_16();
+        _rightPos = Q16_16::fromInt(stripLength() - 1);
+        _leftSpeed = Q16_16::fromInt(1);
+        _rightSpeed = Q16_16::fromInt(1);
         _collisionFlash = 0;
         _phase = PHASE_APPROACH;
         _pauseUntil = 0;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 35) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 35; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         // Clear strip
         fill_solid(leds, numLeds, CRGB::Black);
 
@@ -27,81 +31,79 @@ public:
             uint8_t brightness = _collisionFlash;
             fill_solid(leds, numLeds, CRGB(brightness, brightness, brightness));
             _collisionFlash = qsub8(_collisionFlash, 40);
-            FastLED.show();
-            return;
+            return true;
         }
 
         // Handle pause
-        if (millis() < _pauseUntil) {
+        if (timeMs() < _pauseUntil) {
             drawDots(leds, numLeds);
-            FastLED.show();
-            return;
+            return true;
         }
 
         switch (_phase) {
             case PHASE_APPROACH:
                 // Move toward each other, accelerating
-                _leftSpeed = min(_leftSpeed + 0.05f, 2.5f);
-                _rightSpeed = min(_rightSpeed + 0.05f, 2.5f);
+                _leftSpeed = (_leftSpeed + APPROACH_ACCEL).clamp(Q16_16(), APPROACH_MAX);
+                _rightSpeed = (_rightSpeed + APPROACH_ACCEL).clamp(Q16_16(), APPROACH_MAX);
                 _leftPos += _leftSpeed;
                 _rightPos -= _rightSpeed;
 
                 // Check for collision in the middle
-                if (_leftPos >= _rightPos - 2) {
+                if (_leftPos >= _rightPos - Q16_16::fromInt(2)) {
                     _collisionFlash = 255;
                     _phase = PHASE_RETREAT;
-                    _leftSpeed = 2.0f;
-                    _rightSpeed = 2.0f;
+                    _leftSpeed = Q16_16::fromInt(2);
+                    _rightSpeed = Q16_16::fromInt(2);
                 }
                 break;
 
             case PHASE_RETREAT:
                 // Move back to edges, decelerating
-                _leftSpeed = max(_leftSpeed - 0.03f, 0.5f);
-                _rightSpeed = max(_rightSpeed - 0.03f, 0.5f);
+                _leftSpeed = (_leftSpeed - RETREAT_DECEL).clamp(RETREAT_MIN, APPROACH_MAX);
+                _rightSpeed = (_rightSpeed - RETREAT_DECEL).clamp(RETREAT_MIN, APPROACH_MAX);
                 _leftPos -= _leftSpeed;
                 _rightPos += _rightSpeed;
 
                 // Return to starting positions
-                if (_leftPos <= 0) {
-                    _leftPos = 0;
-                    _leftSpeed = 0;
+                const Q16_16 home = Q16_16::fromInt(numLeds - 1);
+                if (_leftPos <= Q16_16()) {
+                    _leftPos = Q16_16();
+                    _leftSpeed = Q16_16();
                 }
-                if (_rightPos >= numLeds - 1) {
-                    _rightPos = numLeds - 1;
-                    _rightSpeed = 0;
+                if (_rightPos >= home) {
+                    _rightPos = home;
+                    _rightSpeed = Q16_16();
                 }
 
                 // Both returned - pause then restart
-                if (_leftPos <= 0 && _rightPos >= numLeds - 1) {
-                    _pauseUntil = millis() + 800;
+                if (_leftPos <= Q16_16() && _rightPos >= home) {
+                    _pauseUntil = timeMs() + 800;
                     _phase = PHASE_APPROACH;
-                    _leftSpeed = 0.5f;
-                    _rightSpeed = 0.5f;
+                    _leftSpeed = RETREAT_MIN;
+                    _rightSpeed = RETREAT_MIN;
                 }
                 break;
         }
 
         drawDots(leds, numLeds);
-        FastLED.show();
+        return true;
     }
 
 private:
     enum Phase { PHASE_APPROACH, PHASE_RETREAT };
 
-    float _leftPos = 0;
-    float _rightPos = NUM_LEDS - 1;
-    float _leftSpeed = 1.0f;
-    float _rightSpeed = 1.0f;
+    Q16_16 _leftPos;
+    Q16_16 _rightPos;
+    Q16_16 _leftSpeed = Q16_16::fromInt(1);
+    Q16_16 _rightSpeed = Q16_16::fromInt(1);
     uint8_t _collisionFlash = 0;
     Phase _phase = PHASE_APPROACH;
-    uint32_t _lastUpdate = 0;
     uint32_t _pauseUntil = 0;
 
-    void drawDots(CRGB* leds, uint8_t numLeds) {
+    void drawDots(CRGB* leds, uint16_t numLeds) {
         // Draw left player dot (blue) with trail
         for (int t = 0; t < 4; t++) {
-            int p = (int)_leftPos - t;
+            int p = _leftPos.toInt() - t;
             if (p >= 0 && p < numLeds) {
                 uint8_t brightness = 255 - t * 60;
                 leds[p] = CRGB(0, 0, brightness);
@@ -110,7 +112,7 @@ private:
 
         // Draw right player dot (green) with trail
         for (int t = 0; t < 4; t++) {
-            int p = (int)_rightPos + t;
+            int p = _rightPos.toInt() + t;
             if (p >= 0 && p < numLeds) {
                 uint8_t brightness = 255 - t * 60;
                 leds[p] = CRGB(0, brightness, 0);
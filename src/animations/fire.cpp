@@ -1,24 +1,35 @@
 #include "animation.h"
+#include "color_lut.h"
+
+// Heat to flame colour: red, then orange-yellow, white-yellow when hottest
+static constexpr ColorLut HEAT_COLORS = makeColorLut([](uint8_t temperature) {
+    // scale8_video(temperature, 191)
+    uint8_t t192 = ((temperature * 191) >> 8) + (temperature ? 1 : 0);
+
+    uint8_t heatramp = (t192 & 0x3F) << 2;
+    if (t192 > 0x80) return ColorLut::Rgb{255, 255, heatramp};
+    if (t192 > 0x40) return ColorLut::Rgb{255, heatramp, 0};
+    return ColorLut::Rgb{heatramp, 0, 0};
+});
 
 class FireAnimation : public Animation {
 public:
     FireAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         // Initialize heat array
-        for (int i = 0; i < NUM_LEDS; i++) {
+        for (int i = 0; i < MAX_NUM_LEDS; i++) {
             _heat[i] = 0;
         }
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 30) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 30; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         // Cool down every cell a little
+        uint32_t maxCooling = ((COOLING * 10) / numLeds) + 2;
         for (int i = 0; i < numLeds; i++) {
-            uint8_t cooling = random(0, ((COOLING * 10) / numLeds) + 2);
+            uint8_t cooling = rng().below(maxCooling);
             if (cooling > _heat[i]) {
                 _heat[i] = 0;
             } else {
@@ -35,47 +46,27 @@ public:
         }
 
         // Randomly ignite new sparks at the edges (player zones)
-        if (random(255) < SPARKING) {
-            int pos = random(0, 3);
-            _heat[pos] = qadd8(_heat[pos], random(160, 255));
+        if (rng().below(255) < SPARKING) {
+            int pos = rng().below(3);
+            _heat[pos] = qadd8(_heat[pos], rng().range(160, 255));
         }
-        if (random(255) < SPARKING) {
-            int pos = numLeds - 1 - random(0, 3);
-            _heat[pos] = qadd8(_heat[pos], random(160, 255));
+        if (rng().below(255) < SPARKING) {
+            int pos = numLeds - 1 - rng().below(3);
+            _heat[pos] = qadd8(_heat[pos], rng().range(160, 255));
         }
 
         // Map heat to colors
         for (int i = 0; i < numLeds; i++) {
-            leds[i] = heatColor(_heat[i]);
+            leds[i] = HEAT_COLORS[_heat[i]];
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
     static const uint8_t COOLING = 55;
     static const uint8_t SPARKING = 120;
-    uint8_t _heat[NUM_LEDS];
-    uint32_t _lastUpdate = 0;
-
-    // Convert heat value to flame color
-    CRGB heatColor(uint8_t temperature) {
-        uint8_t t192 = scale8_video(temperature, 191);
-
-        uint8_t heatramp = t192 & 0x3F;
-        heatramp <<= 2;
-
-        if (t192 > 0x80) {
-            // Hottest: white-yellow
-            return CRGB(255, 255, heatramp);
-        } else if (t192 > 0x40) {
-            // Middle: yellow-orange
-            return CRGB(255, heatramp, 0);
-        } else {
-            // Coolest: red-orange
-            return CRGB(heatramp, 0, 0);
-        }
-    }
+    uint8_t _heat[MAX_NUM_LEDS];
 };
 
 REGISTER_ANIMATION(FireAnimation, "Fire");
@@ -5,15 +5,13 @@ public:
     HeartbeatAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         _phase = 0;
         _brightness = 0;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 10) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 10; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         _phase++;
 
         // Heartbeat timing pattern (lub-dub pause)
@@ -46,7 +44,7 @@ public:
         _brightness = targetBrightness;
 
         // Pulse outward from center
-        uint8_t center = numLeds / 2;
+        uint16_t center = numLeds / 2;
 
         for (int i = 0; i < numLeds; i++) {
             // Distance from center (0 at center, 1 at edges)
@@ -59,11 +57,10 @@ public:
             leds[i] = CRGB(ledBrightness, ledBrightness / 8, ledBrightness / 10);
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
-    uint32_t _lastUpdate = 0;
     uint16_t _phase = 0;
     uint8_t _brightness = 0;
 };
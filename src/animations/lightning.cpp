@@ -5,24 +5,22 @@ public:
     LightningAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         _flashBrightness = 0;
         _rumbleBrightness = 0;
-        _nextFlash = millis() + random(500, 2000);
+        _nextFlash = timeMs() + rng().range(500, 2000);
         _flashCount = 0;
         _inFlashSequence = false;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 15) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 15; }
 
-        uint32_t now = millis();
+    bool update(CRGB* leds, uint16_t numLeds) override {
+        uint32_t now = timeMs();
 
         // Trigger new flash sequence
         if (!_inFlashSequence && now >= _nextFlash) {
             _inFlashSequence = true;
-            _flashCount = 1 + random(0, 3);  // 1-3 flashes per sequence
+            _flashCount = 1 + rng().below(3);  // 1-3 flashes per sequence
             _flashBrightness = 255;
         }
 
@@ -36,12 +34,12 @@ public:
                     // Brief pause then next flash
                     _flashCount--;
                     if (_flashCount > 0) {
-                        _flashBrightness = 200 + random(0, 55);
+                        _flashBrightness = 200 + rng().below(55);
                     } else {
                         // End of sequence, start rumble
                         _inFlashSequence = false;
                         _rumbleBrightness = 120;
-                        _nextFlash = now + random(1500, 4000);
+                        _nextFlash = now + rng().range(1500, 4000);
                     }
                 }
             }
@@ -59,23 +57,22 @@ public:
                 leds[i] = CRGB(_flashBrightness, _flashBrightness, _flashBrightness);
             } else if (_rumbleBrightness > 0) {
                 // Purple/blue rumble afterglow with some variation
-                uint8_t variation = sin8(i * 15 + millis() / 10) / 4;
+                uint8_t variation = sin8(i * 15 + timeMs() / 10) / 4;
                 uint8_t r = (_rumbleBrightness / 3) + variation / 2;
                 uint8_t g = 0;
                 uint8_t b = _rumbleBrightness + variation;
                 leds[i] = CRGB(r, g, b);
             } else {
                 // Dark with occasional dim flicker
-                uint8_t ambient = random(0, 8);
+                uint8_t ambient = rng().below(8);
                 leds[i] = CRGB(ambient / 2, 0, ambient);
             }
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
-    uint32_t _lastUpdate = 0;
     uint32_t _nextFlash = 0;
     uint8_t _flashBrightness = 0;
     uint8_t _rumbleBrightness = 0;
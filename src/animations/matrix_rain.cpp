@@ -5,24 +5,22 @@ public:
     MatrixRainAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         // Initialize drops
         for (int i = 0; i < NUM_DROPS; i++) {
-            _dropPos[i] = random(0, NUM_LEDS);
-            _dropSpeed[i] = 1 + random(0, 3);
-            _dropLength[i] = 3 + random(0, 5);
-            _dropDelay[i] = random(0, 100);
+            _dropPos[i] = rng().below(stripLength());
+            _dropSpeed[i] = 1 + rng().below(3);
+            _dropLength[i] = 3 + rng().below(5);
+            _dropDelay[i] = rng().below(100);
         }
         // Clear brightness array
-        for (int i = 0; i < NUM_LEDS; i++) {
+        for (int i = 0; i < MAX_NUM_LEDS; i++) {
             _brightness[i] = 0;
         }
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 40) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 40; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         // Fade existing pixels
         for (int i = 0; i < numLeds; i++) {
             _brightness[i] = qsub8(_brightness[i], 25);
@@ -52,15 +50,15 @@ public:
             // Reset drop when it exits
             if (_dropPos[d] - _dropLength[d] >= numLeds) {
                 _dropPos[d] = 0;
-                _dropSpeed[d] = 1 + random(0, 3);
-                _dropLength[d] = 3 + random(0, 5);
-                _dropDelay[d] = random(0, 50);
+                _dropSpeed[d] = 1 + rng().below(3);
+                _dropLength[d] = 3 + rng().below(5);
+                _dropDelay[d] = rng().below(50);
             }
         }
 
         // Occasional bright glitch
-        if (random(100) < 3) {
-            int pos = random(numLeds);
+        if (rng().chance(3)) {
+            int pos = rng().below(numLeds);
             _brightness[pos] = 255;
         }
 
@@ -71,7 +69,7 @@ public:
             leds[i] = CRGB(r, g, r / 2);
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
@@ -80,8 +78,7 @@ private:
     int _dropSpeed[NUM_DROPS];
     int _dropLength[NUM_DROPS];
     int _dropDelay[NUM_DROPS];
-    uint8_t _brightness[NUM_LEDS];
-    uint32_t _lastUpdate = 0;
+    uint8_t _brightness[MAX_NUM_LEDS];
 };
 
 REGISTER_ANIMATION(MatrixRainAnimation, "Matrix Rain");
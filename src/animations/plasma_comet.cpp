@@ -1,4 +1,5 @@
 #include "animation.h"
+#include "color_lut.h"
 
 class PlasmaCometAnimation : public Animation {
 public:
@@ -6,21 +7,22 @@ public:
 
     void reset() override {
         _hue = 0;
-        _cometPos = NUM_LEDS / 2;
+        _cometPos = stripLength() / 2;
         _cometDir = 1;
-        _lastUpdate = 0;
+
+        // The background only varies in hue, so convert each hue once
+        _palette.fill([](uint8_t hue) { return CRGB(CHSV(hue, 220, 90)); });
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 45) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 45; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         _hue += 1;
 
         // Draw plasma background
-        for (uint8_t i = 0; i < numLeds; i++) {
-            uint8_t h = _hue + i * 10 + sin8(millis() / 30 + i * 6);
-            leds[i] = CHSV(h, 220, 90);
+        for (uint16_t i = 0; i < numLeds; i++) {
+            uint8_t h = _hue + i * 10 + sin8(timeMs() / 30 + i * 6);
+            leds[i] = _palette[h];
         }
 
         // Draw comet with trail
@@ -43,14 +45,14 @@ public:
             _cometDir = -1;
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
     uint32_t _hue = 0;
-    int _cometPos = NUM_LEDS / 2;
+    int _cometPos = 0;
     int _cometDir = 1;
-    uint32_t _lastUpdate = 0;
+    ColorLut _palette;
 };
 
 REGISTER_ANIMATION(PlasmaCometAnimation, "Plasma Comet");
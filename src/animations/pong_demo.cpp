@@ -5,17 +5,15 @@ public:
     PongDemoAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _ballPos = NUM_LEDS / 2;
+        _ballPos = stripLength() / 2;
         _ballDir = 1;
         _delay = 120;
-        _lastUpdate = 0;
         _zoneSize = ZONE_SIZE_START;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < _delay) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return _delay; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         // Clear and draw zones
         fill_solid(leds, numLeds, CRGB::Black);
         for (uint8_t i = 0; i < _zoneSize; i++) {
@@ -36,18 +34,17 @@ public:
         if (_ballPos <= 0 || _ballPos >= numLeds - 1) {
             _ballPos = numLeds / 2;
             _delay = 120;
-            _ballDir = (random(0, 2) == 0) ? -1 : 1;
+            _ballDir = (rng().below(2) == 0) ? -1 : 1;
         }
 
         leds[_ballPos] = CRGB::White;
-        FastLED.show();
+        return true;
     }
 
 private:
-    int _ballPos = NUM_LEDS / 2;
+    int _ballPos = 0;
     int _ballDir = 1;
     uint16_t _delay = 120;
-    uint32_t _lastUpdate = 0;
     uint8_t _zoneSize = ZONE_SIZE_START;
 };
 
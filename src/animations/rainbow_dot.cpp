@@ -8,15 +8,13 @@ public:
         _hue = 0;
         _pos = 0;
         _dir = 1;
-        _lastUpdate = 0;
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 40) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 40; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         _hue += 2;
-        for (uint8_t i = 0; i < numLeds; i++) {
+        for (uint16_t i = 0; i < numLeds; i++) {
             leds[i] = CHSV(_hue + i * 8, 255, 90);
         }
         leds[_pos] = CRGB::White;
@@ -26,14 +24,13 @@ public:
             _dir = -_dir;
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
     uint32_t _hue = 0;
-    uint8_t _pos = 0;
+    uint16_t _pos = 0;
     int8_t _dir = 1;
-    uint32_t _lastUpdate = 0;
 };
 
 REGISTER_ANIMATION(RainbowDotAnimation, "Rainbow Dot");
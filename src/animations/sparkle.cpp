@@ -5,28 +5,26 @@ public:
     SparkleAnimation(const char* name) : Animation(name) {}
 
     void reset() override {
-        _lastUpdate = 0;
         _lastShootingStar = 0;
         _shootingStarPos = -1;
         _shootingStarHue = 0;
         // Initialize all stars as off
-        for (int i = 0; i < NUM_LEDS; i++) {
+        for (int i = 0; i < MAX_NUM_LEDS; i++) {
             _brightness[i] = 0;
             _targetBrightness[i] = 0;
-            _hue[i] = random(256);
+            _hue[i] = rng().below(256);
         }
     }
 
-    void update(CRGB* leds, uint8_t numLeds) override {
-        if (millis() - _lastUpdate < 25) return;
-        _lastUpdate = millis();
+    uint16_t frameIntervalMs() const override { return 25; }
 
+    bool update(CRGB* leds, uint16_t numLeds) override {
         // Randomly create new twinkles
-        if (random(100) < 15) {
-            int pos = random(numLeds);
+        if (rng().chance(15)) {
+            int pos = rng().below(numLeds);
             if (_targetBrightness[pos] == 0) {
-                _targetBrightness[pos] = random(100, 255);
-                _hue[pos] = random(256);
+                _targetBrightness[pos] = rng().range(100, 255);
+                _hue[pos] = rng().below(256);
             }
         }
 
@@ -57,11 +55,11 @@ public:
         }
 
         // Occasional shooting star
-        if (_shootingStarPos < 0 && millis() - _lastShootingStar > 3000 && random(100) < 5) {
-            _shootingStarPos = random(2) == 0 ? 0 : numLeds - 1;
+        if (_shootingStarPos < 0 && timeMs() - _lastShootingStar > 3000 && rng().chance(5)) {
+            _shootingStarPos = rng().below(2) == 0 ? 0 : numLeds - 1;
             _shootingStarDir = _shootingStarPos == 0 ? 1 : -1;
-            _shootingStarHue = random(256);
-            _lastShootingStar = millis();
+            _shootingStarHue = rng().below(256);
+            _lastShootingStar = timeMs();
         }
 
         // Animate shooting star
@@ -82,17 +80,16 @@ public:
             }
         }
 
-        FastLED.show();
+        return true;
     }
 
 private:
-    uint8_t _brightness[NUM_LEDS];
-    uint8_t _targetBrightness[NUM_LEDS];
-    uint8_t _hue[NUM_LEDS];
+    uint8_t _brightness[MAX_NUM_LEDS];
+    uint8_t _targetBrightness[MAX_NUM_LEDS];
+    uint8_t _hue[MAX_NUM_LEDS];
     int _shootingStarPos = -1;
     int _shootingStarDir = 1;
     uint8_t _shootingStarHue = 0;
-    uint32_t _lastUpdate = 0;
     uint32_t _lastShootingStar = 0;
 };
 
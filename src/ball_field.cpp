@@ -0,0 +1,115 @@
+#include "ball_field.h"
+
+bool BallField::add(int16_t pos, int8_t dir, uint16_t delayMs, uint32_t timeUs) {
+    if (_count >= MAX_BALLS) return false;
+
+    uint8_t b = _count++;
+    _pos[b] = pos;
+    _dir[b] = dir;
+    _delayMs[b] = delayMs;
+    _vel[b] = BALL_VEL_FOR_DELAY(delayMs);
+    _posFx[b] = (dir > 0) ? ((pos + 1) * BALL_POS_ONE) - 1 : pos * BALL_POS_ONE;
+    _history[b].clear();
+    _history[b].record(timeUs, pos, dir);
+    _moved = true;
+    return true;
+}
+
+void BallField::remove(uint8_t ball) {
+    if (ball >= _count) return;
+
+    uint8_t last = --_count;
+    if (ball != last) {
+        _posFx[ball] = _posFx[last];
+        _vel[ball] = _vel[last];
+        _pos[ball] = _pos[last];
+        _dir[ball] = _dir[last];
+        _delayMs[ball] = _delayMs[last];
+        _history[ball] = _history[last];
+    }
+    _moved = true;
+}
+
+bool BallField::step(uint32_t timeUs) {
+    bool moved = false;
+    for (uint8_t b = 0; b < _count; b++) {
+        _posFx[b] += _dir[b] * _vel[b];
+        int16_t led = _posFx[b] >> BALL_POS_SHIFT;  // Arithmetic shift floors negatives
+        if (led != _pos[b]) {
+            _pos[b] = led;
+            _history[b].record(timeUs, led, _dir[b]);
+            moved = true;
+        }
+    }
+    if (moved) _moved = true;
+    return moved;
+}
+
+uint32_t BallField::stepsUntilNextLed() const {
+    uint32_t soonest = UINT32_MAX;
+    for (uint8_t b = 0; b < _count; b++) {
+        int32_t distFx = (_dir[b] > 0)
+            ? ((_pos[b] + 1) * BALL_POS_ONE) - _posFx[b]
+            : _posFx[b] - (_pos[b] * BALL_POS_ONE) + 1;
+        uint32_t steps = (distFx + _vel[b] - 1) / _vel[b];
+        if (steps < soonest) soonest = steps;
+    }
+    return soonest;
+}
+
+void BallField::bounce(uint8_t ball, int8_t dir, uint32_t timeUs) {
+    _dir[ball] = dir;
+    _posFx[ball] = ((2 * _pos[ball] + 1) * BALL_POS_ONE) - 1 - _posFx[ball];
+    _history[ball].record(timeUs, _pos[ball], dir);
+    _moved = true;
+}
+
+void BallField::sendBack(uint8_t ball, int16_t pos, int8_t dir, uint32_t timeUs) {
+    _pos[ball] = pos;
+    _dir[ball] = dir;
+    _posFx[ball] = (dir > 0) ? pos * BALL_POS_ONE : ((pos + 1) * BALL_POS_ONE) - 1;
+    _history[ball].record(timeUs, pos, dir);
+    _moved = true;
+}
+
+void BallField::speedUp(uint8_t ball, uint16_t cutMs) {
+    if (_delayMs[ball] > BALL_DELAY_MIN + cutMs) {
+        _delayMs[ball] -= cutMs;
+    } else {
+        _delayMs[ball] = BALL_DELAY_MIN;
+    }
+    _vel[ball] = BALL_VEL_FOR_DELAY(_delayMs[ball]);
+}
+
+int8_t BallField::judge(PlayerSide player, uint32_t pressUs, uint8_t zoneSize, uint16_t numLeds,
+                        HitJudgement& hit) const {
+    int8_t toward = (player == PLAYER_LEFT) ? -1 : +1;
+    int8_t best = -1;
+    for (uint8_t b = 0; b < _count; b++) {
+        HitJudgement h = judgePress(_history[b], player, pressUs, zoneSize, numLeds);
+        if (h.outcome != HIT_RETURN) continue;
+
+        if (best >= 0) {
+            bool incoming = _dir[b] == toward;
+            bool bestIncoming = _dir[best] == toward;
+            if (incoming != bestIncoming ? !incoming : h.earlyFactor >= hit.earlyFactor) continue;
+        }
+        best = b;
+        hit = h;
+    }
+    return best;
+}
+
+int8_t BallField::findOut(uint16_t numLeds) const {
+    for (uint8_t b = 0; b < _count; b++) {
+        if (_pos[b] < 0 || _pos[b] >= (int16_t)numLeds) return b;
+    }
+    return -1;
+}
+
+bool BallField::anyInZone(PlayerSide player, uint8_t zoneSize, uint16_t numLeds) const {
+    for (uint8_t b = 0; b < _count; b++) {
+        if (inZone(player, _pos[b], zoneSize, numLeds)) return true;
+    }
+    return false;
+}
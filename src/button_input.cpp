@@ -0,0 +1,96 @@
+#include "button_input.h"
+#include "perf_counters.h"
+
+// Static member initialization
+SpscRing<ButtonEvent, BUTTON_RING_SIZE> ButtonInput::_ring;
+volatile TaskHandle_t ButtonInput::_consumer = nullptr;
+EdgeDebouncer ButtonInput::_left(BUTTON_LOCKOUT_US);
+EdgeDebouncer ButtonInput::_right(BUTTON_LOCKOUT_US);
+portMUX_TYPE ButtonInput::_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void ButtonInput::init() {
+    pinMode(BUTTON_LEFT_PIN, INPUT_PULLUP);
+    pinMode(BUTTON_RIGHT_PIN, INPUT_PULLUP);
+
+    // Start from the current levels so a held button is not reported
+    uint32_t now = micros();
+    _left.settle(readPressed(PLAYER_LEFT), now);
+    _right.settle(readPressed(PLAYER_RIGHT), now);
+
+    attachInterrupt(digitalPinToInterrupt(BUTTON_LEFT_PIN), onLeftEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(BUTTON_RIGHT_PIN), onRightEdge, CHANGE);
+}
+
+bool IRAM_ATTR ButtonInput::readPressed(PlayerSide player) {
+    uint8_t pin = (player == PLAYER_LEFT) ? BUTTON_LEFT_PIN : BUTTON_RIGHT_PIN;
+    return digitalRead(pin) == BUTTON_ACTIVE_LEVEL;
+}
+
+// Call with _mux held; returns true if a press went in
+bool IRAM_ATTR ButtonInput::push(PlayerSide player, EdgeType edge, uint32_t nowUs) {
+    if (edge == EDGE_NONE) return false;
+
+    bool pushed = _ring.push(ButtonEvent{player, edge == EDGE_PRESS, nowUs});
+    PerfCounters::count(pushed ? PERF_INPUT_EDGES : PERF_INPUT_DROPS);
+    return pushed && edge == EDGE_PRESS;
+}
+
+void IRAM_ATTR ButtonInput::onLeftEdge() {
+    onEdge(PLAYER_LEFT, _left);
+}
+
+void IRAM_ATTR ButtonInput::onRightEdge() {
+    onEdge(PLAYER_RIGHT, _right);
+}
+
+void IRAM_ATTR ButtonInput::onEdge(PlayerSide player, EdgeDebouncer& debouncer) {
+    uint32_t now = micros();
+    bool level = readPressed(player);
+    portENTER_CRITICAL_ISR(&_mux);
+    bool pressed = push(player, debouncer.onEdge(level, now), now);
+    portEXIT_CRITICAL_ISR(&_mux);
+
+    TaskHandle_t consumer = _consumer;
+    if (pressed && consumer) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(consumer, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+void ButtonInput::settle() {
+    bool levelL = readPressed(PLAYER_LEFT);
+    bool levelR = readPressed(PLAYER_RIGHT);
+    uint32_t now = micros();
+
+    portENTER_CRITICAL(&_mux);
+    bool pressed = push(PLAYER_LEFT, _left.settle(levelL, now), now);
+    pressed |= push(PLAYER_RIGHT, _right.settle(levelR, now), now);
+    portEXIT_CRITICAL(&_mux);
+
+    TaskHandle_t consumer = _consumer;
+    if (pressed && consumer) xTaskNotifyGive(consumer);
+}
+
+void ButtonInput::inject(const ButtonEvent& ev) {
+    portENTER_CRITICAL_ISR(&_mux);
+    bool pressed = push(ev.player, ev.pressed ? EDGE_PRESS : EDGE_RELEASE, ev.timestampUs);
+    portEXIT_CRITICAL_ISR(&_mux);
+
+    TaskHandle_t consumer = _consumer;
+    if (pressed && consumer) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(consumer, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+void ButtonInput::waitForPress(uint32_t ms) {
+    _consumer = xTaskGetCurrentTaskHandle();
+
+    // Drop a wake-up left by a press already read, then sleep unless one
+    // is waiting. A press landing after the check still wakes the take.
+    ulTaskNotifyTake(pdTRUE, 0);
+    if (!_ring.empty()) return;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
+}
@@ -1,4 +1,5 @@
 #include "button_led.h"
+#include "effect_scheduler.h"
 #include <FastLED.h>
 
 // Static member initialization
@@ -7,8 +8,12 @@ uint8_t ButtonLED::_breathPhase = 0;
 uint32_t ButtonLED::_lastAttentionPulse = 0;
 bool ButtonLED::_inAttentionPulse = false;
 uint8_t ButtonLED::_attentionPhase = 0;
+uint32_t ButtonLED::_attentionGapMs = 10000;
+Rng ButtonLED::_rng;
 
 void ButtonLED::init() {
+    _rng = Rng::stream(RNG_STREAM_BUTTON_LED);
+
     // Configure PWM channels
     ledcSetup(PWM_CHANNEL_LEFT, BUTTON_LED_PWM_FREQ, BUTTON_LED_PWM_RES);
     ledcSetup(PWM_CHANNEL_RIGHT, BUTTON_LED_PWM_FREQ, BUTTON_LED_PWM_RES);
@@ -38,37 +43,30 @@ void ButtonLED::setOff() {
 }
 
 // Gameplay: Active zone - bright steady light
+// Channels currently playing a scheduled effect are left alone
 void ButtonLED::setActiveZone(bool leftActive, bool rightActive) {
-    ledcWrite(PWM_CHANNEL_LEFT, leftActive ? 255 : 0);
-    ledcWrite(PWM_CHANNEL_RIGHT, rightActive ? 255 : 0);
+    if (!EffectScheduler::ownsButton(true)) {
+        ledcWrite(PWM_CHANNEL_LEFT, leftActive ? 255 : 0);
+    }
+    if (!EffectScheduler::ownsButton(false)) {
+        ledcWrite(PWM_CHANNEL_RIGHT, rightActive ? 255 : 0);
+    }
 }
 
-// Gameplay: Successful hit - quick flash then fade
+// Gameplay: Successful hit - quick flash then fade (non-blocking)
 void ButtonLED::flashHit(bool isLeft) {
-    uint8_t channel = isLeft ? PWM_CHANNEL_LEFT : PWM_CHANNEL_RIGHT;
-
     // Quick bright flash
-    ledcWrite(channel, 255);
-    delay(50);
+    EffectScheduler::postButton(isLeft, 0, 50, 255, 255);
 
-    // Fade out
-    for (int b = 255; b >= 0; b -= 15) {
-        ledcWrite(channel, b);
-        delay(10);
-    }
-
-    ledcWrite(channel, 0);
+    // Fade out over 180ms
+    EffectScheduler::postButton(isLeft, 50, 180, 255, 0);
 }
 
-// Gameplay: Miss - rapid blinks 3x
+// Gameplay: Miss - rapid blinks 3x (non-blocking)
 void ButtonLED::blinkMiss(bool isLeft) {
-    uint8_t channel = isLeft ? PWM_CHANNEL_LEFT : PWM_CHANNEL_RIGHT;
-
-    for (int i = 0; i < 3; i++) {
-        ledcWrite(channel, 255);
-        delay(100);
-        ledcWrite(channel, 0);
-        delay(80);
+    for (uint8_t i = 0; i < 3; i++) {
+        EffectScheduler::postButton(isLeft, i * 180, 100, 255, 255);
+        EffectScheduler::postButton(isLeft, i * 180 + 100, 80, 0, 0);
     }
 }
 
@@ -80,7 +78,7 @@ void ButtonLED::pulseCountdown(uint8_t brightness) {
 
 // Idle: Breathing pattern - slow fade in/out
 void ButtonLED::updateBreathing() {
-    if (millis() - _lastBreathUpdate < 20) return;
+    if (millis() - _lastBreathUpdate < BREATH_INTERVAL_MS) return;
     _lastBreathUpdate = millis();
 
     _breathPhase++;
@@ -94,13 +92,20 @@ void ButtonLED::updateBreathing() {
     ledcWrite(PWM_CHANNEL_RIGHT, brightness);
 }
 
+// Idle: Time until the breathing pattern next steps
+uint32_t ButtonLED::msUntilNextBreath() {
+    uint32_t elapsed = millis() - _lastBreathUpdate;
+    return elapsed < BREATH_INTERVAL_MS ? BREATH_INTERVAL_MS - elapsed : 0;
+}
+
 // Idle: Attention-grabbing occasional bright pulse
 void ButtonLED::triggerAttentionPulse() {
     // Trigger pulse every 8-12 seconds randomly
-    if (!_inAttentionPulse && millis() - _lastAttentionPulse > random(8000, 12000)) {
+    if (!_inAttentionPulse && millis() - _lastAttentionPulse > _attentionGapMs) {
         _inAttentionPulse = true;
         _attentionPhase = 0;
         _lastAttentionPulse = millis();
+        _attentionGapMs = _rng.range(8000, 12000);
     }
 
     if (_inAttentionPulse) {
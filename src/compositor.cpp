@@ -0,0 +1,66 @@
+#include "compositor.h"
+
+// ======================================================
+// Layer Implementation
+// ======================================================
+void Layer::clear() {
+    for (uint16_t i = _span.first; i < _span.end; i++) {
+        _covered[i / 8] &= ~(1 << (i % 8));
+    }
+    _changed.mark(_span);
+    _span = DirtyRange();
+}
+
+void Layer::set(uint16_t index, CRGB color) {
+    if (index >= MAX_NUM_LEDS) return;
+    _pixels[index] = color;
+    _covered[index / 8] |= 1 << (index % 8);
+    _span.mark(index, 1);
+    _changed.mark(index, 1);
+}
+
+void Layer::fill(uint16_t first, uint16_t count, CRGB color) {
+    for (uint16_t i = first; i < first + count; i++) {
+        set(i, color);
+    }
+}
+
+DirtyRange Layer::takeChanged() {
+    DirtyRange changed = _changed;
+    _changed = DirtyRange();
+    return changed;
+}
+
+// ======================================================
+// Compositor Implementation
+// ======================================================
+void Compositor::add(Layer* layer) {
+    if (_count < MAX_LAYERS) {
+        _layers[_count++] = layer;
+    }
+}
+
+DirtyRange Compositor::compose(CRGB* out, uint16_t numLeds) {
+    DirtyRange dirty;
+    if (!_valid) dirty = DirtyRange::all(numLeds);
+    for (uint8_t l = 0; l < _count; l++) {
+        dirty.mark(_layers[l]->takeChanged());
+    }
+    dirty = dirty.clipped(numLeds);
+    _valid = true;
+
+    for (uint16_t i = dirty.first; i < dirty.end; i++) {
+        CRGB c = CRGB::Black;
+        for (uint8_t l = 0; l < _count; l++) {
+            const Layer& layer = *_layers[l];
+            if (!layer.covers(i)) continue;
+            if (layer.blend() == BLEND_ADD) {
+                c += layer.pixel(i);
+            } else {
+                c = layer.pixel(i);
+            }
+        }
+        out[i] = c;
+    }
+    return dirty;
+}
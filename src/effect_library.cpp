@@ -0,0 +1,85 @@
+#include "effect_library.h"
+#include <LittleFS.h>
+
+static_assert(sizeof(EffectAnimation) <= ANIMATION_SLOT_SIZE, "EffectAnimation does not fit ANIMATION_SLOT_SIZE");
+static_assert(alignof(EffectAnimation) <= ANIMATION_SLOT_ALIGN, "EffectAnimation needs more than ANIMATION_SLOT_ALIGN");
+
+// ======================================================
+// Built-in Programs
+// ======================================================
+// Ocean Wave: three weighted sine waves mapped through the ocean palette
+static const uint8_t OCEAN_WAVE_PROGRAM[] = {
+    EFFECT_HEADER(30),
+    EFFECT_OP_WAVE, 3,
+        5, 2, 8, 0,      // weight, speed, step per LED, phase
+        3, 3, 12, 64,
+        2, 1, 5, 128,
+    EFFECT_OP_PALETTE, EFFECT_PALETTE_OCEAN,
+};
+
+// Cylon: an orange-red eye sweeping out past each end and back
+static const uint8_t CYLON_PROGRAM[] = {
+    EFFECT_HEADER(55),
+    EFFECT_OP_FILL, 0, 0, 0,
+    EFFECT_OP_TRAIL, 6, 245, 0, 128, 1, EFFECT_MOTION_BOUNCE,  // radius, sigma 2.45, centre start, speed
+        255, 85, 0,      // centre colour
+        255, 0, 0,       // edge colour
+};
+
+static const EffectSource BUILTINS[] = {
+    {"Ocean Wave", OCEAN_WAVE_PROGRAM, sizeof(OCEAN_WAVE_PROGRAM)},
+    {"Cylon", CYLON_PROGRAM, sizeof(CYLON_PROGRAM)},
+};
+
+const EffectSource* EffectLibrary::builtins() { return BUILTINS; }
+uint8_t EffectLibrary::builtinCount() { return sizeof(BUILTINS) / sizeof(BUILTINS[0]); }
+
+// ======================================================
+// Program Files
+// ======================================================
+EffectLibrary::LoadedEffect EffectLibrary::_loaded[EFFECT_FILES_MAX];
+uint8_t EffectLibrary::_loadedCount = 0;
+
+Animation* EffectLibrary::create(void* mem, const void* context) {
+    const LoadedEffect* effect = (const LoadedEffect*)context;
+    return new (mem) EffectAnimation(effect->name, effect->code, effect->length);
+}
+
+uint8_t EffectLibrary::loadFiles(Print& log) {
+    if (!LittleFS.begin(false)) return 0;
+    File dir = LittleFS.open(EFFECT_DIR);
+    if (!dir || !dir.isDirectory()) return 0;
+
+    uint8_t loaded = 0;
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        const char* fileName = file.name();
+        const char* ext = strrchr(fileName, '.');
+        if (file.isDirectory() || !ext || strcmp(ext, ".fx") != 0) continue;
+        if (_loadedCount >= EFFECT_FILES_MAX) {
+            log.printf("Effect %s skipped: only %u files load\n", fileName, EFFECT_FILES_MAX);
+            continue;
+        }
+
+        LoadedEffect& effect = _loaded[_loadedCount];
+        size_t size = file.size();
+        if (size > EFFECT_PROGRAM_MAX || file.read(effect.code, size) != size ||
+            !effectProgramValid(effect.code, size)) {
+            log.printf("Effect %s rejected: not a valid program\n", fileName);
+            continue;
+        }
+
+        size_t nameLen = min((size_t)(ext - fileName), (size_t)EFFECT_NAME_MAX - 1);
+        memcpy(effect.name, fileName, nameLen);
+        effect.name[nameLen] = '\0';
+        effect.length = size;
+        effect.entry = AnimationEntry{effect.name, sizeof(EffectAnimation), create, &effect};
+        if (!AnimationManager::getInstance().registerAnimation(&effect.entry)) {
+            log.printf("Effect %s skipped: %u animations already registered\n", effect.name, MAX_ANIMATIONS);
+            break;
+        }
+        _loadedCount++;
+        loaded++;
+        log.printf("Effect %s loaded\n", effect.name);
+    }
+    return loaded;
+}
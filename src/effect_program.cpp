@@ -0,0 +1,223 @@
+#include "effect_program.h"
+#include "palettes.h"
+#include <math.h>
+
+// Operand bytes after the opcode; WAVE and GRADIENT add 4 per term or stop
+static uint16_t opSize(const uint8_t* op) {
+    switch (op[0]) {
+        case EFFECT_OP_FILL:     return 4;
+        case EFFECT_OP_FADE:     return 2;
+        case EFFECT_OP_WAVE:     return 2 + op[1] * 4;
+        case EFFECT_OP_PALETTE:  return 2;
+        case EFFECT_OP_GRADIENT: return 2 + op[1] * 4;
+        case EFFECT_OP_TRAIL:    return 13;
+        case EFFECT_OP_PARTICLE: return 6;
+        default:                 return 0;
+    }
+}
+
+// ======================================================
+// Validation
+// ======================================================
+bool effectProgramValid(const uint8_t* code, uint16_t length) {
+    if (length < EFFECT_HEADER_SIZE || length > EFFECT_PROGRAM_MAX) return false;
+    if (code[0] != 'F' || code[1] != 'X' || code[2] != EFFECT_VERSION || code[3] == 0) return false;
+
+    uint8_t trails = 0;
+    uint8_t gradients = 0;
+    bool customPalette = false;
+    uint16_t at = EFFECT_HEADER_SIZE;
+    while (at < length) {
+        const uint8_t* op = code + at;
+        // Variable-length ops need their count byte before their size is known
+        if (at + 2 > length) return false;
+        uint16_t size = opSize(op);
+        if (size == 0 || at + size > length) return false;
+
+        switch (op[0]) {
+            case EFFECT_OP_WAVE: {
+                if (op[1] == 0 || op[1] > EFFECT_WAVE_TERMS_MAX) return false;
+                uint16_t totalWeight = 0;
+                for (uint8_t k = 0; k < op[1]; k++) {
+                    totalWeight += op[2 + k * 4];
+                }
+                if (totalWeight == 0) return false;
+                break;
+            }
+            case EFFECT_OP_PALETTE:
+                if (op[1] >= EFFECT_PALETTE_COUNT) return false;
+                if (op[1] == EFFECT_PALETTE_CUSTOM) customPalette = true;
+                break;
+            case EFFECT_OP_GRADIENT:
+                if (op[1] < 2 || op[1] > EFFECT_GRADIENT_MAX || ++gradients > 1) return false;
+                for (uint8_t s = 1; s < op[1]; s++) {
+                    if (op[2 + s * 4] <= op[2 + (s - 1) * 4]) return false;  // Stops must ascend
+                }
+                break;
+            case EFFECT_OP_TRAIL:
+                if (op[1] > EFFECT_TRAIL_RADIUS_MAX || ++trails > EFFECT_TRAILS_MAX) return false;
+                if (op[6] > EFFECT_MOTION_WRAP) return false;
+                break;
+            case EFFECT_OP_PARTICLE:
+                if (op[2] > 100) return false;
+                break;
+            default:
+                break;
+        }
+        at += size;
+    }
+    // The custom palette is only defined by a GRADIENT, anywhere in the program
+    return !customPalette || gradients == 1;
+}
+
+// ======================================================
+// Interpreter
+// ======================================================
+void EffectAnimation::reset() {
+    _time = 0;
+    memset(_values, 0, sizeof(_values));
+
+    uint8_t nextTrail = 0;
+    for (uint16_t at = EFFECT_HEADER_SIZE; at < _length; at += opSize(_code + at)) {
+        const uint8_t* op = _code + at;
+        if (op[0] == EFFECT_OP_GRADIENT) buildGradient(op);
+        if (op[0] == EFFECT_OP_TRAIL) startTrail(op, _trails[nextTrail++]);
+    }
+}
+
+bool EffectAnimation::update(CRGB* leds, uint16_t numLeds) {
+    _time++;
+
+    uint8_t nextTrail = 0;
+    for (uint16_t at = EFFECT_HEADER_SIZE; at < _length; at += opSize(_code + at)) {
+        const uint8_t* op = _code + at;
+        switch (op[0]) {
+            case EFFECT_OP_FILL:     fill_solid(leds, numLeds, CRGB(op[1], op[2], op[3])); break;
+            case EFFECT_OP_FADE:     fadeToBlackBy(leds, numLeds, op[1]); break;
+            case EFFECT_OP_WAVE:     wave(op, numLeds); break;
+            case EFFECT_OP_PALETTE:  palette(op, leds, numLeds); break;
+            case EFFECT_OP_TRAIL:    trail(op, _trails[nextTrail++], leds, numLeds); break;
+            case EFFECT_OP_PARTICLE: particles(op, leds, numLeds); break;
+            default:                 break;  // GRADIENT was applied at reset
+        }
+    }
+    return true;
+}
+
+// The term count is a template argument so the per-LED loop is unrolled
+// for it, as a hand-written animation would be
+template<uint8_t N>
+static void waveTerms(const uint8_t* terms, uint16_t time, uint8_t* values, uint16_t numLeds) {
+    uint8_t weight[N], angle[N], step[N];
+    uint32_t total = 0;
+    for (uint8_t k = 0; k < N; k++) {
+        const uint8_t* term = terms + k * 4;
+        weight[k] = term[0];
+        angle[k] = (uint8_t)(time * term[1] + term[3]);
+        step[k] = term[2];
+        total += term[0];
+    }
+
+    for (uint16_t i = 0; i < numLeds; i++) {
+        uint32_t sum = total / 2;
+        for (uint8_t k = 0; k < N; k++) {
+            sum += weight[k] * sin8(angle[k]);
+            angle[k] += step[k];
+        }
+        values[i] = sum / total;
+    }
+}
+
+void EffectAnimation::wave(const uint8_t* op, uint16_t numLeds) {
+    switch (op[1]) {
+        case 1: waveTerms<1>(op + 2, _time, _values, numLeds); break;
+        case 2: waveTerms<2>(op + 2, _time, _values, numLeds); break;
+        case 3: waveTerms<3>(op + 2, _time, _values, numLeds); break;
+        default: waveTerms<4>(op + 2, _time, _values, numLeds); break;
+    }
+}
+
+void EffectAnimation::palette(const uint8_t* op, CRGB* leds, uint16_t numLeds) {
+    const ColorLut& lut = (op[1] == EFFECT_PALETTE_OCEAN) ? OCEAN_COLORS : _custom;
+    for (uint16_t i = 0; i < numLeds; i++) {
+        leds[i] = lut[_values[i]];
+    }
+}
+
+void EffectAnimation::buildGradient(const uint8_t* op) {
+    const uint8_t* stops = op + 2;
+    uint8_t last = op[1] - 1;
+    _custom.fill([stops, last](uint8_t x) {
+        // Clamp outside the stops, interpolate linearly between them
+        if (x <= stops[0]) return CRGB(stops[1], stops[2], stops[3]);
+        const uint8_t* hi = stops + 4;
+        while (hi < stops + last * 4 && x > hi[0]) hi += 4;
+        const uint8_t* lo = hi - 4;
+        if (x >= hi[0]) return CRGB(hi[1], hi[2], hi[3]);
+
+        int32_t span = hi[0] - lo[0];
+        int32_t t = x - lo[0];
+        auto mix = [span, t](uint8_t a, uint8_t b) { return (uint8_t)(a + ((int32_t)b - a) * t / span); };
+        return CRGB(mix(lo[1], hi[1]), mix(lo[2], hi[2]), mix(lo[3], hi[3]));
+    });
+}
+
+// The glow never changes shape, so its colours are worked out once here
+void EffectAnimation::startTrail(const uint8_t* op, Trail& state) {
+    uint8_t radius = op[1];
+    float sigma = (op[2] | (op[3] << 8)) / 100.0f;
+    const uint8_t* centre = op + 7;
+    const uint8_t* edge = op + 10;
+    for (uint8_t d = 0; d <= radius; d++) {
+        float value = sigma > 0 ? expf(-(float)(d * d) / (2.0f * sigma * sigma)) : (d == 0 ? 1.0f : 0.0f);
+        int32_t b = ((uint8_t)(value * 255.0f + 0.5f) * 255) >> 8;
+        state.colors[d] = CRGB(edge[0] + ((int32_t)centre[0] - edge[0]) * b / 255,
+                               edge[1] + ((int32_t)centre[1] - edge[1]) * b / 255,
+                               edge[2] + ((int32_t)centre[2] - edge[2]) * b / 255);
+    }
+    state.pos = (int16_t)(((uint32_t)stripLength() * op[4]) >> 8);
+    state.dir = ((int8_t)op[5] < 0) ? -1 : 1;
+}
+
+void EffectAnimation::trail(const uint8_t* op, Trail& state, CRGB* leds, uint16_t numLeds) {
+    int16_t radius = op[1];
+    bool wrap = op[6] == EFFECT_MOTION_WRAP;
+
+    for (int16_t d = -radius; d <= radius; d++) {
+        int16_t p = state.pos + d;
+        if (wrap) {
+            if (p < 0) p += numLeds;
+            else if (p >= (int16_t)numLeds) p -= numLeds;
+        }
+        if (p < 0 || p >= (int16_t)numLeds) continue;
+
+        leds[p] = state.colors[d < 0 ? -d : d];
+    }
+
+    int8_t speed = (int8_t)op[5];
+    int16_t step = speed < 0 ? -speed : speed;
+    if (wrap) {
+        // A step can be several strip lengths on a short strip
+        int16_t n = numLeds;
+        state.pos = ((state.pos + state.dir * step) % n + n) % n;
+        return;
+    }
+
+    // The whole glow leaves the strip before it turns back
+    if (state.pos + radius < 0) {
+        state.pos = -radius;
+        state.dir = 1;
+    } else if (state.pos - radius >= (int16_t)numLeds) {
+        state.pos = numLeds + radius;
+        state.dir = -1;
+    }
+    state.pos += state.dir * step;
+}
+
+void EffectAnimation::particles(const uint8_t* op, CRGB* leds, uint16_t numLeds) {
+    for (uint8_t n = 0; n < op[1]; n++) {
+        if (rng().chance(op[2])) {
+            leds[rng().below(numLeds)] = CRGB(op[3], op[4], op[5]);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include "effect_scheduler.h"
+#include "button_led.h"
+
+// Static member initialization
+EffectKeyframe EffectScheduler::_keyframes[MAX_EFFECT_KEYFRAMES];
+uint8_t EffectScheduler::_count = 0;
+
+// Signed elapsed time so keyframes scheduled in the future read as negative
+static int32_t elapsedMs(const EffectKeyframe& kf, uint32_t now) {
+    return (int32_t)(now - kf.startMs);
+}
+
+void EffectScheduler::post(const EffectKeyframe& keyframe) {
+    if (_count < MAX_EFFECT_KEYFRAMES) {
+        _keyframes[_count++] = keyframe;
+    }
+}
+
+void EffectScheduler::postButton(bool isLeft, uint32_t delayMs, uint16_t durationMs,
+                                 uint8_t from, uint8_t to) {
+    EffectKeyframe kf;
+    kf.startMs = millis() + delayMs;
+    kf.durationMs = durationMs;
+    kf.target = isLeft ? EFFECT_BUTTON_LEFT : EFFECT_BUTTON_RIGHT;
+    kf.from = from;
+    kf.to = to;
+    kf.first = 0;
+    kf.count = 0;
+    kf.color = CRGB::Black;
+    post(kf);
+}
+
+void EffectScheduler::postStrip(uint32_t delayMs, uint16_t durationMs,
+                                uint16_t first, uint16_t count, CRGB color) {
+    EffectKeyframe kf;
+    kf.startMs = millis() + delayMs;
+    kf.durationMs = durationMs;
+    kf.target = EFFECT_STRIP;
+    kf.from = 0;
+    kf.to = 0;
+    kf.first = first;
+    kf.count = count;
+    kf.color = color;
+    post(kf);
+}
+
+void EffectScheduler::tick() {
+    uint32_t now = millis();
+
+    // Retire finished keyframes, latching each button's final brightness
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        const EffectKeyframe& kf = _keyframes[i];
+        if (elapsedMs(kf, now) >= (int32_t)kf.durationMs) {
+            if (kf.target != EFFECT_STRIP) {
+                ButtonLED::setBrightness(kf.target == EFFECT_BUTTON_LEFT, kf.to);
+            }
+            continue;
+        }
+        _keyframes[kept++] = kf;
+    }
+    _count = kept;
+
+    // Ramp active button keyframes (later posts win on overlap)
+    for (uint8_t i = 0; i < _count; i++) {
+        const EffectKeyframe& kf = _keyframes[i];
+        if (kf.target == EFFECT_STRIP) continue;
+
+        int32_t elapsed = elapsedMs(kf, now);
+        if (elapsed < 0) continue;
+
+        int32_t span = (int32_t)kf.to - (int32_t)kf.from;
+        uint8_t brightness = kf.from + span * elapsed / kf.durationMs;
+        ButtonLED::setBrightness(kf.target == EFFECT_BUTTON_LEFT, brightness);
+    }
+}
+
+// True while a strip keyframe is drawn
+static bool stripActive(const EffectKeyframe& kf, uint32_t now) {
+    if (kf.target != EFFECT_STRIP) return false;
+    int32_t elapsed = elapsedMs(kf, now);
+    return elapsed >= 0 && elapsed < (int32_t)kf.durationMs;
+}
+
+bool EffectScheduler::render(CRGB* leds, uint16_t numLeds, uint32_t now) {
+    bool drawn = false;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        const EffectKeyframe& kf = _keyframes[i];
+        if (!stripActive(kf, now)) continue;
+
+        for (uint16_t p = kf.first; p < kf.first + kf.count && p < numLeds; p++) {
+            leds[p] = kf.color;
+        }
+        drawn = true;
+    }
+    return drawn;
+}
+
+bool EffectScheduler::render(Layer& layer, uint16_t numLeds, uint32_t now) {
+    bool drawn = false;
+
+    for (uint8_t i = 0; i < _count; i++) {
+        const EffectKeyframe& kf = _keyframes[i];
+        if (!stripActive(kf, now) || kf.first >= numLeds) continue;
+
+        layer.fill(kf.first, min(kf.count, (uint16_t)(numLeds - kf.first)), kf.color);
+        drawn = true;
+    }
+    return drawn;
+}
+
+bool EffectScheduler::ownsButton(bool isLeft) {
+    EffectTarget target = isLeft ? EFFECT_BUTTON_LEFT : EFFECT_BUTTON_RIGHT;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_keyframes[i].target == target) return true;
+    }
+    return false;
+}
@@ -0,0 +1,76 @@
+#include "frame_kernels.h"
+
+// Strip length with a fixed-length blend besides NUM_LEDS_DEFAULT: one 5m
+// reel at 30 LEDs/m
+#define FRAME_KERNEL_LENGTH 150
+
+// ======================================================
+// Wire Encoding
+// ======================================================
+// One runtime-length loop for every strip: fixed-length copies measured
+// within the benchmark's noise of it (about 5% at 55 and 150 LEDs), so
+// they were not worth the code size.
+void FrameKernels::encode(uint8_t* dest, const CRGB* src, uint16_t numLeds, uint8_t brightness) {
+    const uint8_t order = COLOR_ORDER;
+    const uint8_t first = (order >> 6) & 3;
+    const uint8_t second = (order >> 3) & 3;
+    const uint8_t third = order & 3;
+
+    if (brightness == 255) {
+        for (uint16_t i = 0; i < numLeds; i++) {
+            const uint8_t* rgb = src[i].raw;
+            dest[0] = rgb[first];
+            dest[1] = rgb[second];
+            dest[2] = rgb[third];
+            dest += 3;
+        }
+        return;
+    }
+    for (uint16_t i = 0; i < numLeds; i++) {
+        const uint8_t* rgb = src[i].raw;
+        dest[0] = scale8_video(rgb[first], brightness);
+        dest[1] = scale8_video(rgb[second], brightness);
+        dest[2] = scale8_video(rgb[third], brightness);
+        dest += 3;
+    }
+}
+
+// ======================================================
+// Cross-Fade Blend
+// ======================================================
+// Forced inline so every caller gets its own copy: with a constant numLeds
+// the compiler specialises the loop for that length.
+static inline __attribute__((always_inline))
+void blendLoop(CRGB* dest, const CRGB* from, const CRGB* to, uint16_t numLeds, fract8 amount) {
+    uint8_t* d = dest[0].raw;
+    const uint8_t* a = from[0].raw;
+    const uint8_t* b = to[0].raw;
+    for (uint16_t k = 0; k < numLeds * 3; k++) {
+        d[k] = blend8(a[k], b[k], amount);
+    }
+}
+
+template<uint16_t N>
+static void blendFixed(CRGB* dest, const CRGB* from, const CRGB* to, fract8 amount) {
+    blendLoop(dest, from, to, N, amount);
+}
+
+bool FrameKernels::isSpecialised(uint16_t numLeds) {
+    return numLeds == NUM_LEDS_DEFAULT || numLeds == FRAME_KERNEL_LENGTH;
+}
+
+void FrameKernels::blend(CRGB* dest, const CRGB* from, const CRGB* to, uint16_t numLeds, fract8 amount) {
+    if (numLeds == NUM_LEDS_DEFAULT) {
+        blendFixed<NUM_LEDS_DEFAULT>(dest, from, to, amount);
+    } else if (numLeds == FRAME_KERNEL_LENGTH) {
+        blendFixed<FRAME_KERNEL_LENGTH>(dest, from, to, amount);
+    } else {
+        blendGeneric(dest, from, to, numLeds, amount);
+    }
+}
+
+// Kept out of line so the fallback really is the runtime-length loop
+void __attribute__((noinline)) FrameKernels::blendGeneric(CRGB* dest, const CRGB* from, const CRGB* to,
+                                                         uint16_t numLeds, fract8 amount) {
+    blendLoop(dest, from, to, numLeds, amount);
+}
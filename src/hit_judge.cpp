@@ -0,0 +1,60 @@
+#include "hit_judge.h"
+
+// ======================================================
+// Ball History Implementation
+// ======================================================
+void BallHistory::record(uint32_t timeUs, int16_t pos, int8_t dir) {
+    _samples[_head] = BallSample{timeUs, pos, dir};
+    _head = (_head + 1) % BALL_HISTORY_SIZE;
+    if (_count < BALL_HISTORY_SIZE) _count++;
+}
+
+bool BallHistory::sampleAt(uint32_t timeUs, BallSample& out) const {
+    if (_count == 0) return false;
+
+    // Walk back from the newest sample; signed deltas survive micros() wrap
+    for (uint8_t i = 0; i < _count; i++) {
+        uint8_t idx = (_head + BALL_HISTORY_SIZE - 1 - i) % BALL_HISTORY_SIZE;
+        if ((int32_t)(timeUs - _samples[idx].timeUs) >= 0) {
+            out = _samples[idx];
+            return true;
+        }
+    }
+
+    out = _samples[(_head + BALL_HISTORY_SIZE - _count) % BALL_HISTORY_SIZE];
+    return true;
+}
+
+// ======================================================
+// Hit Judgement Implementation
+// ======================================================
+bool inZone(PlayerSide player, int pos, uint8_t zoneSize, uint16_t numLeds) {
+    if (player == PLAYER_LEFT) {
+        return pos >= 0 && pos < (int)zoneSize;
+    }
+    return pos >= (int)numLeds - (int)zoneSize && pos < (int)numLeds;
+}
+
+Q16_16 earlyHitFactor(PlayerSide player, int pos, uint8_t zoneSize, uint16_t numLeds) {
+    if (zoneSize <= 1) return Q16_16();
+    int depth = (player == PLAYER_LEFT) ? pos : (numLeds - 1 - pos);
+    return Q16_16::fromRatio(depth, zoneSize - 1);
+}
+
+HitJudgement judgePress(const BallHistory& history, PlayerSide player, uint32_t pressUs,
+                        uint8_t zoneSize, uint16_t numLeds) {
+    HitJudgement result;
+    result.outcome = HIT_PENALTY;
+    result.pos = -1;
+    result.earlyFactor = Q16_16();
+
+    BallSample sample;
+    if (!history.sampleAt(pressUs, sample)) return result;
+
+    result.pos = sample.pos;
+    if (inZone(player, sample.pos, zoneSize, numLeds)) {
+        result.outcome = HIT_RETURN;
+        result.earlyFactor = earlyHitFactor(player, sample.pos, zoneSize, numLeds);
+    }
+    return result;
+}
@@ -0,0 +1,315 @@
+#include "led_output.h"
+#include "frame_kernels.h"
+#include "ws2812_codec.h"
+#include "perf_counters.h"
+
+// WS2812 framing: 24 bits per LED at 800kHz, then a low latch period
+#define WS2812_BIT_NS    1250
+#define WS2812_LATCH_US  300
+
+// Static member initialization
+CRGB* LedOutput::_leds = nullptr;
+uint16_t LedOutput::_numLeds = 0;
+volatile uint8_t LedOutput::_brightness = 255;
+TaskHandle_t LedOutput::_task = nullptr;
+TripleBuffer<LedOutput::Frame> LedOutput::_frames;
+TripleBuffer<LedFrameTiming> LedOutput::_timings;
+uint32_t LedOutput::_frameCount = 0;
+bool LedOutput::_hashing = false;
+uint32_t LedOutput::_frameHash = 0;
+LedSegmentMap LedOutput::_map;
+uint8_t LedOutput::_wire[LED_SEGMENT_COUNT][LED_SEGMENT_MAX_LEDS * 3];
+uint16_t LedOutput::_sendLeds[LED_SEGMENT_COUNT];
+uint16_t LedOutput::_sentLeds[LED_SEGMENT_COUNT];
+uint32_t LedOutput::_wireErrors = 0;
+volatile bool LedOutput::_busy = false;
+uint32_t LedOutput::_completeUs = 0;
+uint32_t LedOutput::_lastSeq = 0;
+uint32_t LedOutput::_encodedSeq = 0;
+uint8_t LedOutput::_encodedBrightness = 0;
+uint32_t LedOutput::_dropped = 0;
+
+#ifdef ARDUINO_ARCH_ESP32
+
+// ======================================================
+// RMT Transmitter (ESP32)
+// ======================================================
+// The RMT peripheral clocks each segment's wire buffer out on its own
+// channel; the translator expands bytes into pulse items from the RMT
+// interrupt as the hardware memory blocks drain, so the CPU only pays for
+// encoding and all segments run in parallel.
+#include <driver/rmt.h>
+
+#define LED_RMT_CHANNEL RMT_CHANNEL_0  // Segment s uses LED_RMT_CHANNEL + s
+#define LED_RMT_CLK_DIV 2  // 80MHz APB / 2 = one WS2812_TICK_NS tick
+
+static void IRAM_ATTR ws2812Translate(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                      size_t wantedNum, size_t* translatedSize, size_t* itemNum) {
+    *translatedSize = Ws2812Codec::encode((const uint8_t*)src, srcSize, (uint32_t*)dest,
+                                          wantedNum, itemNum);
+}
+
+static volatile uint32_t txEndUs[LED_SEGMENT_COUNT];
+static uint8_t txActive = 0;  // Segments started this frame
+
+static rmt_channel_t segmentChannel(uint8_t segment) {
+    return (rmt_channel_t)(LED_RMT_CHANNEL + segment);
+}
+
+static void IRAM_ATTR onTransmitEnd(rmt_channel_t channel, void* arg) {
+    uint8_t segment = channel - LED_RMT_CHANNEL;
+    if (segment < LED_SEGMENT_COUNT) txEndUs[segment] = (uint32_t)esp_timer_get_time();
+}
+
+static void transmitterInit() {
+    for (uint8_t s = 0; s < LED_SEGMENT_COUNT; s++) {
+        rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)LedSegmentMap::pin(s), segmentChannel(s));
+        config.clk_div = LED_RMT_CLK_DIV;
+        rmt_config(&config);
+        rmt_driver_install(segmentChannel(s), 0, 0);
+        rmt_translator_init(segmentChannel(s), ws2812Translate);
+    }
+    rmt_register_tx_end_callback(onTransmitEnd, nullptr);
+}
+
+void LedOutput::startTransmit(uint8_t segment, const uint8_t* data, size_t len) {
+    txEndUs[segment] = 0;
+    txActive |= 1 << segment;
+    _busy = true;
+    rmt_write_sample(segmentChannel(segment), data, len, false);
+}
+
+// Done once every started segment has finished; the frame completes with
+// the last of them
+bool LedOutput::transmitDone() {
+    if (!_busy) return true;
+
+    uint32_t lastEndUs = 0;
+    for (uint8_t s = 0; s < LED_SEGMENT_COUNT; s++) {
+        if (!(txActive & (1 << s))) continue;
+        uint32_t endUs = txEndUs[s];
+        if (endUs == 0) return false;
+        if (lastEndUs == 0 || (int32_t)(endUs - lastEndUs) > 0) lastEndUs = endUs;
+    }
+    _completeUs = lastEndUs + WS2812_LATCH_US;
+    txActive = 0;
+    _busy = false;
+    return true;
+}
+
+void LedOutput::waitIdle() {
+    if (!_busy) return;
+    for (uint8_t s = 0; s < LED_SEGMENT_COUNT; s++) {
+        if (txActive & (1 << s)) rmt_wait_tx_done(segmentChannel(s), portMAX_DELAY);
+    }
+    while (!transmitDone()) {}
+}
+
+// The strip has no return path on the board
+void LedOutput::verifyFrame(const Frame& frame) {}
+
+#else
+
+// ======================================================
+// Modelled Transmitter (host)
+// ======================================================
+// No wire: a frame completes once its longest segment's wire time has
+// elapsed on the clock. The output task sleeps meanwhile, matching the RMT
+// path on the board. Each segment is encoded to WS2812 symbols and decoded
+// again as the strip would read it, so verifyFrame() can check the segment
+// mapping and the codec end to end.
+static uint32_t txEndUs = 0;
+static uint32_t txSymbols[LED_SEGMENT_MAX_LEDS * 3 * 8];
+static uint8_t rxBytes[LED_SEGMENT_COUNT][LED_SEGMENT_MAX_LEDS * 3];
+static int32_t rxCount[LED_SEGMENT_COUNT];
+
+static void transmitterInit() {}
+
+void LedOutput::startTransmit(uint8_t segment, const uint8_t* data, size_t len) {
+    size_t symbols = 0;
+    Ws2812Codec::encode(data, len, txSymbols, sizeof(txSymbols) / sizeof(txSymbols[0]), &symbols);
+    rxCount[segment] = Ws2812Codec::decode(txSymbols, symbols, rxBytes[segment]);
+
+    uint32_t endUs = micros() + wireTimeUs(len / 3);
+    if (!_busy || (int32_t)(endUs - txEndUs) > 0) txEndUs = endUs;
+    _busy = true;
+}
+
+bool LedOutput::transmitDone() {
+    if (_busy && (int32_t)(micros() - txEndUs) >= 0) {
+        _completeUs = txEndUs;
+        _busy = false;
+    }
+    return !_busy;
+}
+
+void LedOutput::waitIdle() {
+    while (!transmitDone()) {
+        vTaskDelay(1);
+    }
+}
+
+// Reassemble the decoded segments into the logical strip and compare with
+// the frame as shown; blanked tails must decode as black
+void LedOutput::verifyFrame(const Frame& frame) {
+    static uint8_t expected[MAX_NUM_LEDS * 3];
+    FrameKernels::encode(expected, frame.leds, frame.numLeds, _brightness);
+
+    bool ok = true;
+    for (uint8_t s = 0; s < _map.count() && ok; s++) {
+        ok = rxCount[s] == (int32_t)_sendLeds[s] * 3;
+        for (int32_t k = _map[s].count * 3; k < rxCount[s] && ok; k++) {
+            ok = rxBytes[s][k] == 0;
+        }
+    }
+    for (uint16_t i = 0; i < frame.numLeds && ok; i++) {
+        uint8_t segment;
+        uint16_t offset;
+        ok = _map.locate(i, segment, offset) &&
+             memcmp(rxBytes[segment] + offset * 3, expected + i * 3, 3) == 0;
+    }
+    if (!ok) _wireErrors++;
+}
+
+#endif
+
+// ======================================================
+// Frame Submission (game side)
+// ======================================================
+void LedOutput::init(CRGB* leds, uint16_t numLeds) {
+    _leds = leds;
+    setLength(numLeds);
+}
+
+void LedOutput::setLength(uint16_t numLeds) {
+    _numLeds = min(numLeds, (uint16_t)MAX_NUM_LEDS);
+}
+
+void LedOutput::show(const DirtyRange& dirty) {
+    if (!_leds || dirty.empty()) return;
+    PerfTimer timer(PERF_SHOW_US);
+
+    Frame& frame = _frames.back();
+    memcpy(frame.leds, _leds, sizeof(CRGB) * _numLeds);
+    frame.numLeds = _numLeds;
+    frame.dirty = dirty.clipped(_numLeds);
+    frame.submitUs = micros();
+    frame.seq = ++_frameCount;
+    _frames.publish();
+
+    if (_hashing) {
+        const uint8_t* bytes = (const uint8_t*)_leds;
+        for (size_t i = 0; i < sizeof(CRGB) * _numLeds; i++) {
+            _frameHash = (_frameHash ^ bytes[i]) * 16777619UL;
+        }
+    }
+
+    if (_task) xTaskNotifyGive(_task);
+}
+
+void LedOutput::startFrameHash() {
+    _frameHash = 2166136261UL;
+    _hashing = true;
+}
+
+uint32_t LedOutput::stopFrameHash() {
+    _hashing = false;
+    return _frameHash;
+}
+
+LedFrameTiming LedOutput::lastTiming() {
+    _timings.acquire();
+    return _timings.front();
+}
+
+uint32_t LedOutput::wireTimeUs(uint16_t numLeds) {
+    return (uint32_t)numLeds * 24 * WS2812_BIT_NS / 1000 + WS2812_LATCH_US;
+}
+
+// ======================================================
+// Output Task
+// ======================================================
+// The transmitter is set up here so its interrupt lands on the output core
+void LedOutput::begin() {
+    _task = xTaskGetCurrentTaskHandle();
+    transmitterInit();
+}
+
+void LedOutput::service() {
+    // Send each new frame as it arrives. WS2812 LEDs latch the last frame,
+    // so while nothing changes nothing is sent.
+    while (!_frames.acquire()) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    transmit(_frames.front());
+}
+
+void LedOutput::transmit(const Frame& frame) {
+    PerfTimer timer(PERF_TRANSMIT_US);
+    bool relayout = frame.numLeds != _map.numLeds();
+    if (relayout) _map.layout(frame.numLeds);
+
+    // The frame right after the one encoded only needs its changed range;
+    // anything else is encoded in full
+    uint8_t brightness = _brightness;
+    if (relayout || brightness != _encodedBrightness || frame.seq != _encodedSeq + 1) {
+        encode(frame, brightness);
+    } else {
+        encodeRange(frame, brightness);
+        for (uint8_t s = 0; s < _map.count(); s++) {
+            _sendLeds[s] = _sentLeds[s];
+        }
+    }
+    _encodedSeq = frame.seq;
+    _encodedBrightness = brightness;
+
+    // Hold the line low for the latch period of the previous frame
+    int32_t latch = (int32_t)(_completeUs - micros());
+    if (latch > 0) delayMicroseconds(latch);
+
+    uint32_t startUs = micros();
+    for (uint8_t s = 0; s < _map.count(); s++) {
+        if (_sendLeds[s] > 0) startTransmit(s, _wire[s], (size_t)_sendLeds[s] * 3);
+    }
+    waitIdle();
+    verifyFrame(frame);
+
+    if (frame.seq > _lastSeq + 1) _dropped += frame.seq - _lastSeq - 1;
+    if (frame.seq > _lastSeq) _lastSeq = frame.seq;
+
+    LedFrameTiming& timing = _timings.back();
+    timing.submitUs = frame.submitUs;
+    timing.startUs = startUs;
+    timing.completeUs = _completeUs;
+    timing.dropped = _dropped;
+    _timings.publish();
+}
+
+// Apply brightness and colour order into each segment's wire buffer
+void LedOutput::encode(const Frame& frame, uint8_t brightness) {
+    for (uint8_t s = 0; s < _map.count(); s++) {
+        const LedSegment& segment = _map[s];
+        FrameKernels::encode(_wire[s], frame.leds + segment.first, segment.count, brightness);
+
+        // After the strip shrinks, send the old length once with the cut-off
+        // LEDs black so they do not keep their last colour
+        _sendLeds[s] = max(segment.count, _sentLeds[s]);
+        if (_sendLeds[s] > segment.count) {
+            memset(_wire[s] + segment.count * 3, 0, (_sendLeds[s] - segment.count) * 3);
+        }
+        _sentLeds[s] = segment.count;
+    }
+}
+
+// Re-encode only the frame's changed range, segment by segment; the rest of
+// each wire buffer still holds the previous frame
+void LedOutput::encodeRange(const Frame& frame, uint8_t brightness) {
+    for (uint8_t s = 0; s < _map.count(); s++) {
+        const LedSegment& segment = _map[s];
+        uint16_t first = max(frame.dirty.first, segment.first);
+        uint16_t end = min(frame.dirty.end, (uint16_t)(segment.first + segment.count));
+        if (first >= end) continue;
+        FrameKernels::encode(_wire[s] + (first - segment.first) * 3, frame.leds + first,
+                             end - first, brightness);
+    }
+}
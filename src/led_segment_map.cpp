@@ -0,0 +1,38 @@
+#include "led_segment_map.h"
+
+static const uint8_t SEGMENT_PINS[] = {LED_SEGMENT_PINS};
+
+static_assert(sizeof(SEGMENT_PINS) == LED_SEGMENT_COUNT,
+              "LED_SEGMENT_PINS needs one pin per LED_SEGMENT_COUNT");
+static_assert(LED_SEGMENT_COUNT >= 1 && LED_SEGMENT_COUNT <= 8,
+              "LED_SEGMENT_COUNT must fit the 8 RMT channels");
+
+uint8_t LedSegmentMap::pin(uint8_t segment) {
+    return SEGMENT_PINS[segment];
+}
+
+void LedSegmentMap::layout(uint16_t numLeds) {
+    _numLeds = numLeds;
+
+    uint16_t base = numLeds / LED_SEGMENT_COUNT;
+    uint16_t extra = numLeds % LED_SEGMENT_COUNT;
+    uint16_t first = 0;
+    for (uint8_t s = 0; s < LED_SEGMENT_COUNT; s++) {
+        _segments[s].pin = SEGMENT_PINS[s];
+        _segments[s].first = first;
+        _segments[s].count = base + (s < extra ? 1 : 0);
+        first += _segments[s].count;
+    }
+}
+
+bool LedSegmentMap::locate(uint16_t index, uint8_t& segment, uint16_t& offset) const {
+    if (index >= _numLeds) return false;
+    for (uint8_t s = LED_SEGMENT_COUNT; s-- > 0;) {
+        if (index >= _segments[s].first) {
+            segment = s;
+            offset = index - _segments[s].first;
+            return true;
+        }
+    }
+    return false;
+}
@@ -2,25 +2,30 @@
 #include <FastLED.h>
 #include "config.h"
 #include "animation.h"
+#include "animation_bench.h"
 #include "button_led.h"
+#include "button_input.h"
+#include "effect_scheduler.h"
+#include "led_output.h"
+#include "hit_judge.h"
+#include "strip_config.h"
+#include "rng.h"
+#include "compositor.h"
+#include "ball_field.h"
+#include "match_recorder.h"
+#include "perf_counters.h"
+#include "effect_library.h"
 
 // ======================================================
 // LED Array
 // ======================================================
-CRGB leds[NUM_LEDS];
+// Sized for the longest strip; only the first stripLength LEDs are used
+CRGB leds[MAX_NUM_LEDS];
+uint16_t stripLength = NUM_LEDS_DEFAULT;
 
 // ======================================================
 // Game State
 // ======================================================
-enum PlayerSide : uint8_t { PLAYER_LEFT = 0, PLAYER_RIGHT = 1 };
-
-struct ButtonEvent {
-    PlayerSide player;
-    uint32_t   timestampMs;
-};
-
-QueueHandle_t buttonQueue;
-
 enum GameState {
     STATE_IDLE,
     STATE_SERVE,
@@ -31,202 +36,387 @@ enum GameState {
 
 volatile GameState currentState = STATE_IDLE;
 
-int      ballPos        = NUM_LEDS / 2;
-int      ballDir        = 1;
-uint16_t ballDelayMs    = BALL_DELAY_START;
+BallField balls;                                      // Every ball in play
+uint8_t  rallyBalls     = 1;                          // Balls served this rally
 uint8_t  scoreLeft      = 0;
 uint8_t  scoreRight     = 0;
 uint8_t  currentZoneSize = ZONE_SIZE_START;
 PlayerSide lastLoser    = PLAYER_LEFT;
+Rng      gameRng;                                     // Seeds each match's serves
+Rng      serveRng;                                    // Serve directions this match
+
+// Fixed-timestep clock: real time not yet consumed by physics steps
+uint32_t simLastUs      = 0;
+uint32_t simAccumUs     = 0;
+
+// Gameplay layers, bottom to top, and what each was last drawn from
+Layer    zoneLayer(BLEND_REPLACE);                    // Background and both zones
+Layer    ballLayer(BLEND_REPLACE);                    // Ball and comet trail
+Layer    scoreLayer(BLEND_ADD);                       // Score either side of the centre
+Layer    effectLayer(BLEND_REPLACE);                  // Strip effect keyframes
+Compositor gameLayers;
+uint8_t  zonesDrawnSize  = 0;
+uint16_t zonesDrawnLength = 0;
+bool     ballsDrawn     = false;                      // false: ball layer needs drawing
+uint8_t  scoreDrawnLeft  = 0xFF;                      // 0xFF: score layer needs drawing
+uint8_t  scoreDrawnRight = 0xFF;
+
+// Worst-case time the game loop ran without yielding during a match
+uint32_t loopStartUs    = 0;
+uint32_t worstStallUs   = 0;
+
+// Set by the serial console, run by the game task from attract mode
+volatile bool benchRequested = false;
+volatile uint16_t lengthRequested = 0;
+volatile uint8_t ballsPerServe = BALLS_PER_SERVE;
 
 // ======================================================
 // Rendering Helpers
 // ======================================================
 void clearLeds() {
-    fill_solid(leds, NUM_LEDS, COLOR_BACKGROUND);
+    fill_solid(leds, stripLength, COLOR_BACKGROUND);
 }
 
+// The draw functions below redraw their layer only when what it shows has
+// changed; the compositor then repaints just the pixels that differ.
 void drawZones() {
-    for (uint8_t i = 0; i < currentZoneSize; i++) {
-        leds[i] = COLOR_ZONE_LEFT;
-        leds[NUM_LEDS - 1 - i] = COLOR_ZONE_RIGHT;
-    }
+    if (currentZoneSize == zonesDrawnSize && stripLength == zonesDrawnLength) return;
+    zoneLayer.clear();
+    zoneLayer.fill(0, stripLength, COLOR_BACKGROUND);
+    zoneLayer.fill(0, currentZoneSize, COLOR_ZONE_LEFT);
+    zoneLayer.fill(stripLength - currentZoneSize, currentZoneSize, COLOR_ZONE_RIGHT);
+    zonesDrawnSize = currentZoneSize;
+    zonesDrawnLength = stripLength;
 }
 
-void drawBall() {
-    if (ballPos >= 0 && ballPos < NUM_LEDS) {
-        leds[ballPos] = COLOR_BALL;
+void drawBalls() {
+    bool moved = balls.takeMoved();
+    if (!moved && ballsDrawn) return;
+    ballLayer.clear();
+    ballsDrawn = true;
 
-        // 3-LED comet trail
-        int t1 = ballPos - ballDir;
-        int t2 = ballPos - 2 * ballDir;
-        int t3 = ballPos - 3 * ballDir;
+    static const uint8_t TRAIL_FADE[3] = {160, 210, 240};
+    for (uint8_t b = 0; b < balls.count(); b++) {
+        int pos = balls.pos(b);
+        int dir = balls.dir(b);
+        if (pos < 0 || pos >= stripLength) continue;
 
-        if (t1 >= 0 && t1 < NUM_LEDS) {
-            leds[t1] = CRGB::White;
-            leds[t1].fadeToBlackBy(160);
-        }
-        if (t2 >= 0 && t2 < NUM_LEDS) {
-            leds[t2] = CRGB::White;
-            leds[t2].fadeToBlackBy(210);
-        }
-        if (t3 >= 0 && t3 < NUM_LEDS) {
-            leds[t3] = CRGB::White;
-            leds[t3].fadeToBlackBy(240);
+        ballLayer.set(pos, COLOR_BALL);
+
+        // 3-LED comet trail
+        for (int t = 1; t <= 3; t++) {
+            int p = pos - t * dir;
+            if (p >= 0 && p < stripLength) {
+                CRGB trail = CRGB::White;
+                trail.fadeToBlackBy(TRAIL_FADE[t - 1]);
+                ballLayer.set(p, trail);
+            }
         }
     }
 }
 
 void showKeypressFeedback(PlayerSide player) {
-    CRGB savedLeft[ZONE_SIZE_START];
-    CRGB savedRight[ZONE_SIZE_START];
+    uint16_t first = (player == PLAYER_LEFT) ? 0 : stripLength - currentZoneSize;
+    EffectScheduler::postStrip(0, 80, first, currentZoneSize, CRGB(255, 80, 0));
+}
 
-    for (uint8_t i = 0; i < currentZoneSize; i++) {
-        savedLeft[i]  = leds[i];
-        savedRight[i] = leds[NUM_LEDS - 1 - i];
+void drawScoreOverlay() {
+    if (scoreLeft == scoreDrawnLeft && scoreRight == scoreDrawnRight) return;
+    scoreLayer.clear();
+    const uint16_t c = stripLength / 2;
+    for (uint8_t i = 0; i < scoreLeft && (c - 1 - i) >= 0; i++) {
+        scoreLayer.set(c - 1 - i, CRGB(0, 0, 100));
     }
-
-    CRGB orange = CRGB(255, 80, 0);
-    if (player == PLAYER_LEFT) {
-        for (uint8_t i = 0; i < currentZoneSize; i++) leds[i] = orange;
-    } else {
-        for (uint8_t i = 0; i < currentZoneSize; i++) leds[NUM_LEDS - 1 - i] = orange;
+    for (uint8_t i = 0; i < scoreRight && (c + 1 + i) < stripLength; i++) {
+        scoreLayer.set(c + 1 + i, CRGB(0, 100, 0));
     }
+    scoreDrawnLeft = scoreLeft;
+    scoreDrawnRight = scoreRight;
+}
 
-    FastLED.show();
-    vTaskDelay(pdMS_TO_TICKS(80));
+// Effects change with time, so their layer is redrawn while any are active
+// Returns true if any effect was drawn
+bool drawEffects() {
+    if (effectLayer.empty() && !EffectScheduler::isBusy()) return false;
+    effectLayer.clear();
+    return EffectScheduler::render(effectLayer, stripLength, millis());
+}
 
-    if (player == PLAYER_LEFT) {
-        for (uint8_t i = 0; i < currentZoneSize; i++) leds[i] = savedLeft[i];
-    } else {
-        for (uint8_t i = 0; i < currentZoneSize; i++) leds[NUM_LEDS - 1 - i] = savedRight[i];
-    }
+// Forget the ball, score and effect layers, e.g. after attract mode or
+// other effects drew on the strip; the zones stay cached
+void resetGameLayers() {
+    ballLayer.clear();
+    scoreLayer.clear();
+    effectLayer.clear();
+    ballsDrawn = false;
+    scoreDrawnLeft = scoreDrawnRight = 0xFF;
+    gameLayers.invalidate();
+}
 
-    FastLED.show();
+// Composite the layers and send whatever changed; an unchanged frame is
+// not sent at all
+void showLayers() {
+    LedOutput::show(gameLayers.compose(leds, stripLength));
 }
 
-void drawScoreOverlay() {
-    const uint8_t c = NUM_LEDS / 2;
-    for (uint8_t i = 0; i < scoreLeft && (c - 1 - i) >= 0; i++) {
-        leds[c - 1 - i] += CRGB(0, 0, 100);
-    }
-    for (uint8_t i = 0; i < scoreRight && (c + 1 + i) < NUM_LEDS; i++) {
-        leds[c + 1 + i] += CRGB(0, 100, 0);
+// Flash the loser's zone; play goes on around it
+void showMissFlash(PlayerSide p) {
+    uint16_t first = (p == PLAYER_LEFT) ? 0 : stripLength - currentZoneSize;
+    for (uint8_t f = 0; f < 3; f++) {
+        EffectScheduler::postStrip(f * 200, 120, first, currentZoneSize, COLOR_MISS);
     }
 }
 
+// Flash the loser's zone on a blanked strip at the end of a rally
 void showMissAnimation(PlayerSide p) {
     for (uint8_t f = 0; f < 3; f++) {
-        clearLeds();
-        if (p == PLAYER_LEFT) {
-            for (uint8_t i = 0; i < currentZoneSize; i++) leds[i] = COLOR_MISS;
-        } else {
-            for (uint8_t i = 0; i < currentZoneSize; i++) leds[NUM_LEDS - 1 - i] = COLOR_MISS;
-        }
-        FastLED.show();
-        vTaskDelay(pdMS_TO_TICKS(120));
-        clearLeds();
-        FastLED.show();
-        vTaskDelay(pdMS_TO_TICKS(80));
+        EffectScheduler::postStrip(f * 200, 120, 0, stripLength, COLOR_BACKGROUND);
+    }
+    showMissFlash(p);
+    for (uint8_t f = 0; f < 3; f++) {
+        EffectScheduler::postStrip(f * 200 + 120, 80, 0, stripLength, COLOR_BACKGROUND);
     }
 }
 
 void showWinAnimation(PlayerSide w) {
     CRGB col = (w == PLAYER_LEFT) ? COLOR_WIN_LEFT : COLOR_WIN_RIGHT;
     for (uint8_t r = 0; r < 10; r++) {
-        fill_solid(leds, NUM_LEDS, col);
-        FastLED.show();
-        vTaskDelay(pdMS_TO_TICKS(120));
-        clearLeds();
-        FastLED.show();
-        vTaskDelay(pdMS_TO_TICKS(80));
+        EffectScheduler::postStrip(r * 200, 120, 0, stripLength, col);
+        EffectScheduler::postStrip(r * 200 + 120, 80, 0, stripLength, COLOR_BACKGROUND);
     }
     currentZoneSize = ZONE_SIZE_START;
 }
 
+// Gameplay frame with effect overlays on top
+// Returns true if any effect overlay was drawn
+bool renderGameFrame() {
+    drawZones();
+    drawBalls();
+    drawScoreOverlay();
+    bool overlay = drawEffects();
+    showLayers();
+    return overlay;
+}
+
+// Switch the game and output over to a new strip length
+void useStripLength(uint16_t numLeds) {
+    stripLength = numLeds;
+    LedOutput::setLength(numLeds);
+}
+
+// Save a new strip length and switch to it
+void applyStripLength(uint16_t numLeds) {
+    if (!StripConfig::store(numLeds)) return;
+    useStripLength(numLeds);
+    Serial.printf("Strip length %u saved\n", numLeds);
+}
+
+// Record how long the loop has run since it last yielded
+void noteStall() {
+    uint32_t stall = micros() - loopStartUs;
+    if (stall > worstStallUs) worstStallUs = stall;
+}
+
+// Sleep between loop iterations
+void gameSleep(uint32_t ms) {
+    noteStall();
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    loopStartUs = micros();
+}
+
+// Sleep between loop iterations, waking early when a press arrives
+void gameWaitForInput(uint32_t ms) {
+    noteStall();
+    ButtonInput::waitForPress(ms);
+    loopStartUs = micros();
+}
+
+// Take the oldest press; releases are passed over, as play only reacts
+// to presses
+bool nextPress(ButtonEvent& ev) {
+    while (ButtonInput::next(ev)) {
+        if (ev.pressed) return true;
+    }
+    return false;
+}
+
+// Play pending effects on a blank strip
+// Returns false once all effects have finished
+bool playPendingEffects() {
+    if (!EffectScheduler::isBusy()) return false;
+    EffectScheduler::tick();
+    clearLeds();
+    EffectScheduler::render(leds, stripLength);
+    LedOutput::show();
+    gameSleep(EFFECT_TICK_MS);
+    return true;
+}
+
+// Start a match. The recorder logs it, and hands back a recorded match's
+// settings when one is being replayed.
 void resetMatch() {
+    // Begin on a tick, so millis()-timed effects keep the same phase
+    // against the match and a replay renders the same frames
+    vTaskDelay(1);
+
+    MatchSettings settings = MatchRecorder::begin({gameRng.next(), stripLength, ballsPerServe}, micros());
+    serveRng.reseed(settings.seed);
+    if (settings.stripLength != stripLength) useStripLength(settings.stripLength);
+    ballsPerServe = settings.ballsPerServe;
+
     scoreLeft = scoreRight = 0;
-    ballDelayMs = BALL_DELAY_START;
     lastLoser = PLAYER_LEFT;
     currentZoneSize = ZONE_SIZE_START;
+    EffectScheduler::clear();
+    loopStartUs = micros();
+    worstStallUs = 0;
 }
 
 int randomDirection() {
-    return (random(0, 2) == 0) ? -1 : 1;
+    return (serveRng.below(2) == 0) ? -1 : 1;
 }
 
-void prepareServe() {
-    ballPos = NUM_LEDS / 2;
-    ballDelayMs = BALL_DELAY_START;
+// ======================================================
+// Ball Physics
+// ======================================================
+// Time the physics has been advanced to (lags micros() by under a step)
+uint32_t simTimeUs() {
+    return simLastUs - simAccumUs;
+}
+
+// Consume elapsed real time in fixed steps, stopping as soon as a ball
+// reaches a new LED so game logic runs once per LED
+bool advanceSimulation() {
+    uint32_t nowUs = micros();
+    simAccumUs += nowUs - simLastUs;
+    simLastUs = nowUs;
+    if (simAccumUs > SIM_MAX_CATCHUP_US) {
+        simAccumUs = SIM_MAX_CATCHUP_US;
+        PerfCounters::count(PERF_CATCHUP_DROPS);
+    }
+
+    while (simAccumUs >= SIM_STEP_US) {
+        simAccumUs -= SIM_STEP_US;
+        if (balls.step(simTimeUs())) return true;
+    }
+    return false;
+}
+
+// Real time until the first ball reaches its next LED
+uint32_t msUntilNextLed() {
+    uint32_t dueUs = balls.stepsUntilNextLed() * SIM_STEP_US;
+    return (dueUs > simAccumUs) ? (dueUs - simAccumUs) / 1000 : 0;
+}
+
+// Speed up after a return; earlyFactor is 1.0 at zone entry, 0.0 at exit
+void speedUpBall(uint8_t ball, Q16_16 earlyFactor) {
+    balls.speedUp(ball, BALL_SPEEDUP_PER_RETURN + earlyFactor.scale(BALL_EARLY_HIT_MAX_BONUS));
+}
+
+// Successful return, judged at the LED the ball was on when pressed
+void returnBall(uint8_t ball, PlayerSide player, const HitJudgement& hit) {
+    ButtonLED::flashHit(player == PLAYER_LEFT);
+    showKeypressFeedback(player);
+
+    int8_t newDir = (player == PLAYER_LEFT) ? +1 : -1;
+    if (balls.dir(ball) != newDir) {
+        if (hit.pos == balls.pos(ball)) {
+            balls.bounce(ball, newDir, simTimeUs());
+        } else {
+            // Ball moved on before the press was read: send it back from
+            // the LED it was hit on
+            balls.sendBack(ball, hit.pos, newDir, simTimeUs());
+        }
+    }
 
+    speedUpBall(ball, hit.earlyFactor);
+}
+
+// Point to the other player; miss feedback plays before the next serve
+void awardPoint(PlayerSide loser) {
+    ButtonLED::blinkMiss(loser == PLAYER_LEFT);  // Loser's button LED blinks
+    if (loser == PLAYER_LEFT) {
+        scoreRight++;
+    } else {
+        scoreLeft++;
+    }
+    lastLoser = loser;
+
+    // A single-ball rally ends on its first point; a multi-ball one when
+    // the last ball is out or the match is decided
+    bool rallyOver = rallyBalls == 1 || balls.count() == 0 ||
+                     scoreLeft >= SCORE_TO_WIN || scoreRight >= SCORE_TO_WIN;
+    if (rallyOver) {
+        showMissAnimation(loser);
+        currentState = STATE_CHECK_GAME_OVER;
+    } else {
+        showMissFlash(loser);
+    }
+}
+
+void prepareServe() {
+    int8_t dir;
     if (scoreLeft == 0 && scoreRight == 0) {
-        ballDir = randomDirection();
+        dir = randomDirection();
     } else {
-        ballDir = (lastLoser == PLAYER_LEFT) ? -1 : +1;
+        dir = (lastLoser == PLAYER_LEFT) ? -1 : +1;
     }
+    balls.clear();
 
     if (scoreLeft + scoreRight > 0 && currentZoneSize > ZONE_SIZE_MIN) {
         currentZoneSize--;
     }
 
+    // Countdown on the zones alone; the score joins on the first frame
+    resetGameLayers();
+    drawZones();
     for (int c = 3; c > 0; --c) {
-        clearLeds();
-        drawZones();
-        leds[NUM_LEDS / 2] = CRGB::Yellow;
-        FastLED.show();
+        ballLayer.set(stripLength / 2, CRGB::Yellow);
+        showLayers();
         ButtonLED::pulseCountdown(255);  // Bright pulse
-        vTaskDelay(pdMS_TO_TICKS(200));
-        clearLeds();
-        drawZones();
-        FastLED.show();
+        gameSleep(200);
+        ballLayer.clear();
+        showLayers();
         ButtonLED::pulseCountdown(0);  // Off
-        vTaskDelay(pdMS_TO_TICKS(200));
+        gameSleep(200);
     }
     ButtonLED::setOff();  // Ensure off after countdown
+
+    // Start the physics clock, then serve from the centre LED. Extra balls
+    // alternate direction and each pair is a speed step faster.
+    simLastUs = micros();
+    simAccumUs = 0;
+
+    rallyBalls = ballsPerServe;
+    for (uint8_t b = 0; b < rallyBalls; b++) {
+        int8_t ballDir = (b % 2 == 0) ? dir : -dir;
+        uint16_t delayMs = max(BALL_DELAY_START - (b / 2) * BALL_SPEEDUP_PER_RETURN, BALL_DELAY_MIN);
+        balls.add(stripLength / 2, ballDir, delayMs, simTimeUs());
+    }
 }
 
 // ======================================================
 // Tasks
 // ======================================================
+// Presses arrive from the GPIO edge interrupts; this task only catches
+// state changes whose edges all fell inside a debounce lockout
 void buttonTask(void* pvParameters) {
     (void)pvParameters;
-    pinMode(BUTTON_LEFT_PIN, INPUT_PULLUP);
-    pinMode(BUTTON_RIGHT_PIN, INPUT_PULLUP);
-
-    bool lastL = digitalRead(BUTTON_LEFT_PIN) == BUTTON_ACTIVE_LEVEL;
-    bool lastR = digitalRead(BUTTON_RIGHT_PIN) == BUTTON_ACTIVE_LEVEL;
-    bool stableL = lastL, stableR = lastR;
-    uint32_t changeL = millis(), changeR = millis();
-    const uint32_t debounceMs = 20;
+    ButtonInput::init();
 
     for (;;) {
-        uint32_t now = millis();
-        bool rawL = digitalRead(BUTTON_LEFT_PIN) == BUTTON_ACTIVE_LEVEL;
-        bool rawR = digitalRead(BUTTON_RIGHT_PIN) == BUTTON_ACTIVE_LEVEL;
-
-        if (rawL != lastL) {
-            lastL = rawL;
-            changeL = now;
-        } else if ((now - changeL) >= debounceMs && stableL != rawL) {
-            stableL = rawL;
-            if (stableL) {
-                ButtonEvent ev{PLAYER_LEFT, now};
-                xQueueSend(buttonQueue, &ev, 0);
-            }
-        }
+        vTaskDelay(pdMS_TO_TICKS(BUTTON_LOCKOUT_US / 1000));
+        ButtonInput::settle();
+    }
+}
 
-        if (rawR != lastR) {
-            lastR = rawR;
-            changeR = now;
-        } else if ((now - changeR) >= debounceMs && stableR != rawR) {
-            stableR = rawR;
-            if (stableR) {
-                ButtonEvent ev{PLAYER_RIGHT, now};
-                xQueueSend(buttonQueue, &ev, 0);
-            }
-        }
+// Sends frames as the game task publishes them
+void outputTask(void* pvParameters) {
+    (void)pvParameters;
+    LedOutput::begin();
 
-        vTaskDelay(pdMS_TO_TICKS(5));
+    for (;;) {
+        LedOutput::service();
     }
 }
 
@@ -237,26 +427,50 @@ void gameTask(void* pvParameters) {
     AnimationManager& animManager = AnimationManager::getInstance();
     animManager.resetToFirst();
 
-    Serial.printf("Loaded %d animations\n", animManager.getCount());
+    Serial.printf("Loaded %d animations (largest %u of %u arena bytes)\n", animManager.getCount(),
+                  animManager.largestSize(), (unsigned)ANIMATION_SLOT_SIZE);
+
+    gameLayers.add(&zoneLayer);
+    gameLayers.add(&ballLayer);
+    gameLayers.add(&scoreLayer);
+    gameLayers.add(&effectLayer);
+
+    bool overlayVisible = false;
+    bool winPosted = false;
 
     for (;;) {
         switch (currentState) {
 
         case STATE_IDLE: {
+            if (benchRequested) {
+                AnimationBench::run(Serial);
+                benchRequested = false;
+                animManager.resetToFirst();
+                break;
+            }
+            if (lengthRequested) {
+                applyStripLength(lengthRequested);
+                lengthRequested = 0;
+                break;
+            }
+
             ButtonEvent ev;
-            if (xQueueReceive(buttonQueue, &ev, 0) == pdTRUE) {
+            if (nextPress(ev)) {
                 resetMatch();
                 clearLeds();
-                FastLED.show();
+                LedOutput::show();
                 currentState = STATE_SERVE;
                 break;
             }
             // Run attract mode animations
-            animManager.update(leds, NUM_LEDS);
+            animManager.update(leds, stripLength);
 
             // Button LED idle effects
             ButtonLED::updateBreathing();
             ButtonLED::triggerAttentionPulse();
+
+            // Sleep until the next frame or breath step; a press wakes us
+            gameWaitForInput(min(animManager.msUntilNextFrame(), ButtonLED::msUntilNextBreath()));
             break;
         }
 
@@ -266,115 +480,76 @@ void gameTask(void* pvParameters) {
             break;
 
         case STATE_BALL_MOVING: {
-            bool leftPressed = false, rightPressed = false;
-            ButtonEvent ev;
-            while (xQueueReceive(buttonQueue, &ev, 0) == pdTRUE) {
-                if (ev.player == PLAYER_LEFT) leftPressed = true;
-                if (ev.player == PLAYER_RIGHT) rightPressed = true;
-            }
+            PerfTimer iteration(PERF_GAME_LOOP_US);
+            EffectScheduler::tick();
+            bool moved = advanceSimulation();
 
-            ballPos += ballDir;
-
-            bool inLeft  = (ballPos >= 0 && ballPos < (int)currentZoneSize);
-            bool inRight = (ballPos >= (int)NUM_LEDS - (int)currentZoneSize);
-
-            // Button LED active zone indication
-            ButtonLED::setActiveZone(inLeft, inRight);
-
-            // Penalty: press outside zone
-            if (leftPressed && !inLeft) {
-                ButtonLED::blinkMiss(true);  // Left button LED blinks
-                showMissAnimation(PLAYER_LEFT);
-                scoreRight++;
-                lastLoser = PLAYER_LEFT;
-                currentState = STATE_CHECK_GAME_OVER;
-                break;
+            // Judge each press where the ball was when it happened, not
+            // where it is now that the loop reads it
+            ButtonEvent ev;
+            while (currentState == STATE_BALL_MOVING && nextPress(ev)) {
+                MatchRecorder::record(ev);
+                HitJudgement hit;
+                int8_t ball = balls.judge(ev.player, ev.timestampUs, currentZoneSize, stripLength, hit);
+                if (ball >= 0) {
+                    returnBall(ball, ev.player, hit);
+                    moved = true;
+                } else {
+                    awardPoint(ev.player);  // Penalty: press outside zone
+                }
             }
-            if (rightPressed && !inRight) {
-                ButtonLED::blinkMiss(false);  // Right button LED blinks
-                showMissAnimation(PLAYER_RIGHT);
-                scoreLeft++;
-                lastLoser = PLAYER_RIGHT;
-                currentState = STATE_CHECK_GAME_OVER;
+            if (currentState != STATE_BALL_MOVING) break;
+
+            // While every ball stays on its LED only the effects advance
+            if (!moved) {
+                if (overlayVisible || EffectScheduler::isBusy()) {
+                    overlayVisible = renderGameFrame();
+                }
+                uint32_t waitMs = msUntilNextLed();
+                if (waitMs > EFFECT_TICK_MS) waitMs = EFFECT_TICK_MS;
+                iteration.stop();
+                gameWaitForInput(waitMs > 0 ? waitMs : 1);
                 break;
             }
 
-            // Successful hit with early-hit bonus
-            // Early hit = ball just entered zone, late hit = ball about to exit
-            if (inLeft && leftPressed) {
-                ButtonLED::flashHit(true);  // Left button LED flash
-                showKeypressFeedback(PLAYER_LEFT);
-                ballDir = +1;
-
-                // Calculate early hit factor: 1.0 at zone entry, 0.0 at zone exit
-                // Left zone: entry at currentZoneSize-1, exit at 0
-                float earlyFactor = (currentZoneSize > 1)
-                    ? (float)ballPos / (float)(currentZoneSize - 1)
-                    : 0.0f;
-                uint16_t totalSpeedup = BALL_SPEEDUP_PER_RETURN +
-                    (uint16_t)(earlyFactor * BALL_EARLY_HIT_MAX_BONUS);
-
-                if (ballDelayMs > BALL_DELAY_MIN + totalSpeedup)
-                    ballDelayMs -= totalSpeedup;
-                else
-                    ballDelayMs = BALL_DELAY_MIN;
-            }
-            if (inRight && rightPressed) {
-                ButtonLED::flashHit(false);  // Right button LED flash
-                showKeypressFeedback(PLAYER_RIGHT);
-                ballDir = -1;
-
-                // Calculate early hit factor: 1.0 at zone entry, 0.0 at zone exit
-                // Right zone: entry at NUM_LEDS-currentZoneSize, exit at NUM_LEDS-1
-                float earlyFactor = (currentZoneSize > 1)
-                    ? (float)(NUM_LEDS - 1 - ballPos) / (float)(currentZoneSize - 1)
-                    : 0.0f;
-                uint16_t totalSpeedup = BALL_SPEEDUP_PER_RETURN +
-                    (uint16_t)(earlyFactor * BALL_EARLY_HIT_MAX_BONUS);
-
-                if (ballDelayMs > BALL_DELAY_MIN + totalSpeedup)
-                    ballDelayMs -= totalSpeedup;
-                else
-                    ballDelayMs = BALL_DELAY_MIN;
-            }
-
-            // Normal miss
-            if (ballPos < 0) {
-                ButtonLED::blinkMiss(true);  // Left button LED blinks
-                showMissAnimation(PLAYER_LEFT);
-                scoreRight++;
-                lastLoser = PLAYER_LEFT;
-                currentState = STATE_CHECK_GAME_OVER;
-                break;
-            }
-            if (ballPos >= NUM_LEDS) {
-                ButtonLED::blinkMiss(false);  // Right button LED blinks
-                showMissAnimation(PLAYER_RIGHT);
-                scoreLeft++;
-                lastLoser = PLAYER_RIGHT;
-                currentState = STATE_CHECK_GAME_OVER;
-                break;
+            // Button LED active zone indication
+            ButtonLED::setActiveZone(balls.anyInZone(PLAYER_LEFT, currentZoneSize, stripLength),
+                                     balls.anyInZone(PLAYER_RIGHT, currentZoneSize, stripLength));
+
+            // Normal misses: each ball off an end scores for the other side
+            int8_t out;
+            while (currentState == STATE_BALL_MOVING && (out = balls.findOut(stripLength)) >= 0) {
+                PlayerSide loser = (balls.pos(out) < 0) ? PLAYER_LEFT : PLAYER_RIGHT;
+                balls.remove(out);
+                awardPoint(loser);
             }
+            if (currentState != STATE_BALL_MOVING) break;
 
             // Render frame
-            clearLeds();
-            drawZones();
-            drawBall();
-            drawScoreOverlay();
-            FastLED.show();
-
-            vTaskDelay(pdMS_TO_TICKS(ballDelayMs));
+            overlayVisible = renderGameFrame();
             break;
         }
 
         case STATE_CHECK_GAME_OVER:
+            // Let the miss feedback finish before the next serve
+            if (playPendingEffects()) break;
+
             currentState = (scoreLeft >= SCORE_TO_WIN || scoreRight >= SCORE_TO_WIN)
                            ? STATE_GAME_OVER : STATE_SERVE;
             break;
 
         case STATE_GAME_OVER: {
-            PlayerSide winner = (scoreLeft >= SCORE_TO_WIN) ? PLAYER_LEFT : PLAYER_RIGHT;
-            showWinAnimation(winner);
+            if (!winPosted) {
+                PlayerSide winner = (scoreLeft >= SCORE_TO_WIN) ? PLAYER_LEFT : PLAYER_RIGHT;
+                showWinAnimation(winner);
+                winPosted = true;
+            }
+            if (playPendingEffects()) break;
+            winPosted = false;
+            MatchRecorder::end(scoreLeft, scoreRight);
+
+            Serial.printf("Match over: worst game-loop stall %lu us\n", (unsigned long)worstStallUs);
+
             // Reset to first animation after game ends
             animManager.resetToFirst();
             currentState = STATE_IDLE;
@@ -384,29 +559,105 @@ void gameTask(void* pvParameters) {
     }
 }
 
+// ======================================================
+// Serial Console
+// ======================================================
+// Line commands: "bench" times every animation (see AnimationBench),
+// "leds N" sets and saves the strip length, "leds" prints it, "balls N"
+// serves N balls at once from the next serve on, "balls" prints it, "log"
+// prints the last match's log for replay on the host, "perf" prints the
+// performance counters and "perf reset" clears them
+void pollConsole() {
+    static char line[16];
+    static uint8_t len = 0;
+
+    while (Serial.available()) {
+        char c = (char)Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        line[len] = '\0';
+        if (strcmp(line, "bench") == 0) {
+            benchRequested = true;
+        } else if (strcmp(line, "leds") == 0) {
+            Serial.printf("Strip length %u\n", StripConfig::length());
+        } else if (strncmp(line, "leds ", 5) == 0) {
+            long n = atol(line + 5);
+            if (StripConfig::isValid(n)) {
+                lengthRequested = n;
+            } else {
+                Serial.printf("Strip length must be %u to %u\n", MIN_NUM_LEDS, MAX_NUM_LEDS);
+            }
+        } else if (strcmp(line, "log") == 0) {
+            MatchRecorder::dump(Serial);
+#if PERF_COUNTERS
+        } else if (strcmp(line, "perf") == 0) {
+            PerfCounters::dump(Serial);
+        } else if (strcmp(line, "perf reset") == 0) {
+            PerfCounters::reset();
+            Serial.println("Perf counters reset");
+#endif
+        } else if (strcmp(line, "balls") == 0) {
+            Serial.printf("Balls per serve %u\n", ballsPerServe);
+        } else if (strncmp(line, "balls ", 6) == 0) {
+            long n = atol(line + 6);
+            if (n >= 1 && n <= MAX_BALLS) {
+                ballsPerServe = n;
+                Serial.printf("Balls per serve %u\n", ballsPerServe);
+            } else {
+                Serial.printf("Balls per serve must be 1 to %u\n", MAX_BALLS);
+            }
+        } else if (len > 0) {
+            Serial.printf("Unknown command: %s\n", line);
+        }
+        len = 0;
+    }
+}
+
 // ======================================================
 // Setup & Loop
 // ======================================================
+// Create a pinned task and watch its stack in the perf counters
+void startTask(void (*fn)(void*), const char* name, uint32_t stackBytes, UBaseType_t priority,
+               BaseType_t core) {
+    TaskHandle_t task = nullptr;
+    xTaskCreatePinnedToCore(fn, name, stackBytes, NULL, priority, &task, core);
+    PerfCounters::watchTask(task, name, stackBytes);
+}
+
 void setup() {
     Serial.begin(115200);
     delay(200);
 
-    FastLED.addLeds<LED_TYPE, LED_PIN, COLOR_ORDER>(leds, NUM_LEDS);
-    FastLED.setBrightness(BRIGHTNESS);
+    // One seed drives every random stream; set RNG_SEED to it to replay a run
+    Rng::setMasterSeed(RNG_SEED != 0 ? RNG_SEED : esp_random());
+    gameRng = Rng::stream(RNG_STREAM_GAME);
+    Serial.printf("Random seed %lu\n", (unsigned long)Rng::masterSeed());
+
+    StripConfig::load();
+    stripLength = StripConfig::length();
+    Serial.printf("Strip length %u (max %u)\n", stripLength, MAX_NUM_LEDS);
+
+    // Effect programs on the filesystem join the attract animations
+    EffectLibrary::loadFiles(Serial);
+
+    LedOutput::init(leds, stripLength);
+    LedOutput::setBrightness(BRIGHTNESS);
     clearLeds();
-    FastLED.show();
+    LedOutput::show();
 
     // Initialize button LEDs
     ButtonLED::init();
 
-    buttonQueue = xQueueCreate(10, sizeof(ButtonEvent));
-
-    xTaskCreatePinnedToCore(buttonTask, "Btn",  4096, NULL, 2, NULL, 0);
-    xTaskCreatePinnedToCore(gameTask,   "Game", 8192, NULL, 1, NULL, 1);
+    startTask(buttonTask, "Btn",  4096, 2, 0);
+    startTask(outputTask, "Out",  4096, 3, 0);
+    startTask(gameTask,   "Game", 8192, 1, 1);
 
     Serial.println("1D-Pong - Modular Animation System");
 }
 
 void loop() {
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    pollConsole();
+    vTaskDelay(pdMS_TO_TICKS(100));
 }
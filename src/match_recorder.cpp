@@ -0,0 +1,71 @@
+#include "match_recorder.h"
+#include "led_output.h"
+
+// Static member initialization
+MatchLogHeader MatchRecorder::_header = {};
+uint32_t MatchRecorder::_events[MATCH_LOG_MAX_EVENTS];
+bool MatchRecorder::_recording = false;
+bool MatchRecorder::_replayQueued = false;
+MatchSettings MatchRecorder::_replay = {};
+MatchRecorder::Listener MatchRecorder::_started = nullptr;
+MatchRecorder::Listener MatchRecorder::_finished = nullptr;
+
+MatchSettings MatchRecorder::begin(const MatchSettings& settings, uint32_t startUs) {
+    MatchSettings used = _replayQueued ? _replay : settings;
+    _replayQueued = false;
+
+    _header = MatchLogHeader{};
+    _header.magic = MATCH_LOG_MAGIC;
+    _header.version = MATCH_LOG_VERSION;
+    _header.ballsPerServe = used.ballsPerServe;
+    _header.stripLength = used.stripLength;
+    _header.seed = used.seed;
+    _header.startUs = startUs;
+    _recording = true;
+
+    LedOutput::startFrameHash();
+    if (_started) _started(_header, _events);
+    return used;
+}
+
+void MatchRecorder::record(const ButtonEvent& ev) {
+    if (!_recording || _header.eventCount >= MATCH_LOG_MAX_EVENTS) return;
+    _events[_header.eventCount++] = packMatchEvent(ev, _header.startUs);
+}
+
+void MatchRecorder::end(uint8_t scoreLeft, uint8_t scoreRight) {
+    if (!_recording) return;
+    _recording = false;
+    _header.frameHash = LedOutput::stopFrameHash();
+    _header.scoreLeft = scoreLeft;
+    _header.scoreRight = scoreRight;
+
+    if (_finished) _finished(_header, _events);
+}
+
+void MatchRecorder::replayNext(const MatchSettings& settings) {
+    _replay = settings;
+    _replayQueued = true;
+}
+
+static void dumpHex(Print& out, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        out.printf("%02x", bytes[i]);
+    }
+}
+
+void MatchRecorder::dump(Print& out) {
+    if (_header.magic != MATCH_LOG_MAGIC) {
+        out.println("No match recorded");
+        return;
+    }
+    if (_recording) {
+        out.println("Match in progress");
+        return;
+    }
+    out.print("matchlog ");
+    dumpHex(out, &_header, sizeof(_header));
+    dumpHex(out, _events, _header.eventCount * sizeof(uint32_t));
+    out.println();
+}
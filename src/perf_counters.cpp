@@ -0,0 +1,78 @@
+#include "perf_counters.h"
+
+#if PERF_COUNTERS
+
+// Static member initialization
+std::atomic<uint32_t> PerfCounters::_counts[PERF_COUNTER_COUNT];
+std::atomic<uint32_t> PerfCounters::_buckets[PERF_HISTOGRAM_COUNT][PERF_BUCKETS];
+std::atomic<uint32_t> PerfCounters::_maxUs[PERF_HISTOGRAM_COUNT];
+PerfCounters::WatchedTask PerfCounters::_tasks[PERF_MAX_TASKS];
+uint8_t PerfCounters::_taskCount = 0;
+
+static const char* const COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "input_edges", "input_drops", "catchup_drops"
+};
+
+static const char* const HISTOGRAM_NAMES[PERF_HISTOGRAM_COUNT] = {
+    "game_loop_us", "show_us", "transmit_us", "fade_us"
+};
+
+void PerfCounters::sample(PerfHistogram histogram, uint32_t us) {
+    _buckets[histogram][bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t seen = _maxUs[histogram].load(std::memory_order_relaxed);
+    while (us > seen && !_maxUs[histogram].compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+}
+
+void PerfCounters::watchTask(TaskHandle_t task, const char* name, uint32_t stackBytes) {
+    if (!task || _taskCount >= PERF_MAX_TASKS) return;
+    _tasks[_taskCount++] = WatchedTask{task, name, stackBytes};
+}
+
+void PerfCounters::reset() {
+    for (uint8_t c = 0; c < PERF_COUNTER_COUNT; c++) {
+        _counts[c].store(0, std::memory_order_relaxed);
+    }
+    for (uint8_t h = 0; h < PERF_HISTOGRAM_COUNT; h++) {
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+            _buckets[h][b].store(0, std::memory_order_relaxed);
+        }
+        _maxUs[h].store(0, std::memory_order_relaxed);
+    }
+}
+
+// Histograms list only their non-empty buckets as lowerBoundUs:count
+void PerfCounters::dump(Print& out) {
+    out.print("perf");
+    for (uint8_t c = 0; c < PERF_COUNTER_COUNT; c++) {
+        out.printf(" %s=%lu", COUNTER_NAMES[c], (unsigned long)counter((PerfCounter)c));
+    }
+    out.println();
+
+    for (uint8_t h = 0; h < PERF_HISTOGRAM_COUNT; h++) {
+        uint32_t n = 0;
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+            n += bucket((PerfHistogram)h, b);
+        }
+        out.printf("perf %s n=%lu max=%lu", HISTOGRAM_NAMES[h], (unsigned long)n,
+                   (unsigned long)maxUs((PerfHistogram)h));
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+            uint32_t count = bucket((PerfHistogram)h, b);
+            if (count == 0) continue;
+            unsigned long lower = (b == 0) ? 0 : 1UL << (b - 1);
+            out.printf(" %lu:%lu", lower, (unsigned long)count);
+        }
+        out.println();
+    }
+
+    // Unused stack of each watched task at its deepest so far
+    out.print("perf stack_free");
+    for (uint8_t t = 0; t < _taskCount; t++) {
+        out.printf(" %s=%lu/%lu", _tasks[t].name,
+                   (unsigned long)uxTaskGetStackHighWaterMark(_tasks[t].task),
+                   (unsigned long)_tasks[t].stackBytes);
+    }
+    out.println();
+}
+
+#endif
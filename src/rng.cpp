@@ -0,0 +1,3 @@
+#include "rng.h"
+
+uint32_t Rng::_masterSeed = 1;
@@ -0,0 +1,28 @@
+#include "strip_config.h"
+#include <Preferences.h>
+
+#define STRIP_PREFS_NAMESPACE "pong"
+#define STRIP_PREFS_KEY       "leds"
+
+uint16_t StripConfig::_length = NUM_LEDS_DEFAULT;
+
+void StripConfig::load() {
+    Preferences prefs;
+    prefs.begin(STRIP_PREFS_NAMESPACE, true);
+    uint16_t saved = prefs.getUShort(STRIP_PREFS_KEY, NUM_LEDS_DEFAULT);
+    prefs.end();
+
+    _length = isValid(saved) ? saved : NUM_LEDS_DEFAULT;
+}
+
+bool StripConfig::store(uint16_t numLeds) {
+    if (!isValid(numLeds)) return false;
+
+    Preferences prefs;
+    prefs.begin(STRIP_PREFS_NAMESPACE, false);
+    prefs.putUShort(STRIP_PREFS_KEY, numLeds);
+    prefs.end();
+
+    _length = numLeds;
+    return true;
+}
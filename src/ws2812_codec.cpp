@@ -0,0 +1,43 @@
+#include "ws2812_codec.h"
+
+// Runs inside the RMT interrupt on the board, so it must live in IRAM
+size_t IRAM_ATTR Ws2812Codec::encode(const uint8_t* bytes, size_t len, uint32_t* symbols,
+                                     size_t maxSymbols, size_t* symbolCount) {
+    size_t size = 0;
+    size_t num = 0;
+    while (size < len && num + 8 <= maxSymbols) {
+        uint8_t b = bytes[size];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            symbols[num++] = (b & (0x80 >> bit)) ? WS2812_BIT1 : WS2812_BIT0;
+        }
+        size++;
+    }
+    *symbolCount = num;
+    return size;
+}
+
+static bool near(uint16_t ticks, uint16_t target) {
+    return ticks + WS2812_TOL >= target && ticks <= target + WS2812_TOL;
+}
+
+int32_t Ws2812Codec::decode(const uint32_t* symbols, size_t count, uint8_t* bytes) {
+    if (count % 8 != 0) return -1;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t s = symbols[i];
+        uint16_t high = s & 0x7FFF;
+        uint16_t low = (s >> 16) & 0x7FFF;
+        bool level0 = s & (1UL << 15);
+        bool level1 = s & (1UL << 31);
+        if (!level0 || level1) return -1;
+
+        uint8_t& b = bytes[i / 8];
+        if (i % 8 == 0) b = 0;
+        if (near(high, WS2812_T1H) && near(low, WS2812_T1L)) {
+            b |= 0x80 >> (i % 8);
+        } else if (!near(high, WS2812_T0H) || !near(low, WS2812_T0L)) {
+            return -1;
+        }
+    }
+    return count / 8;
+}
@@ -0,0 +1,187 @@
+#include <unity.h>
+#include <thread>
+#include "edge_debouncer.h"
+#include "game_types.h"
+#include "spsc_ring.h"
+
+// ======================================================
+// Input Ring Stress Tests
+// ======================================================
+// One producer and one consumer thread hammer a small ring, as the button
+// ISRs and the game task do. Every event carries its sequence number and
+// a check word, so a lost, duplicated, reordered or torn event shows up.
+
+void setUp() {}
+void tearDown() {}
+
+struct StressEvent {
+    uint32_t seq;
+    uint32_t check;  // ~seq
+};
+
+static const uint32_t STRESS_EVENTS = 200000;
+
+// A producer that retries when the ring is full loses nothing
+static void test_ring_delivers_every_event_in_order() {
+    SpscRing<StressEvent, 32> ring;
+    std::thread producer([&ring] {
+        for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+            while (!ring.push(StressEvent{i, ~i})) std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0;
+    StressEvent ev;
+    while (expected < STRESS_EVENTS) {
+        if (!ring.pop(ev)) {
+            std::this_thread::yield();
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT32(expected, ev.seq);
+        TEST_ASSERT_EQUAL_UINT32(~expected, ev.check);
+        expected++;
+    }
+    producer.join();
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// A producer that never waits, like the ISRs, may overflow the ring; each
+// event is then either read exactly once, in order, or counted as dropped
+static void test_ring_accounts_for_every_drop() {
+    SpscRing<StressEvent, 32> ring;
+    std::atomic<bool> done{false};
+    std::thread producer([&ring, &done] {
+        for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+            ring.push(StressEvent{i, ~i});
+            if (i % 64 == 0) std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    uint32_t received = 0;
+    int64_t last = -1;
+    StressEvent ev;
+    for (;;) {
+        if (ring.pop(ev)) {
+            TEST_ASSERT_TRUE_MESSAGE((int64_t)ev.seq > last, "event duplicated or out of order");
+            TEST_ASSERT_EQUAL_UINT32(~ev.seq, ev.check);
+            last = ev.seq;
+            received++;
+        } else if (done && ring.empty()) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    TEST_ASSERT_EQUAL_UINT32(STRESS_EVENTS, received + ring.dropped());
+}
+
+// Press and release edges keep their order and timestamps through the ring
+static void test_ring_carries_button_events() {
+    SpscRing<ButtonEvent, 4> ring;
+    TEST_ASSERT_TRUE(ring.push(ButtonEvent{PLAYER_LEFT, true, 1000}));
+    TEST_ASSERT_TRUE(ring.push(ButtonEvent{PLAYER_LEFT, false, 81000}));
+    TEST_ASSERT_TRUE(ring.push(ButtonEvent{PLAYER_RIGHT, true, 90000}));
+    TEST_ASSERT_TRUE(ring.push(ButtonEvent{PLAYER_RIGHT, false, 95000}));
+    TEST_ASSERT_FALSE(ring.push(ButtonEvent{PLAYER_LEFT, true, 99000}));
+    TEST_ASSERT_EQUAL_UINT32(1, ring.dropped());
+
+    ButtonEvent ev;
+    TEST_ASSERT_TRUE(ring.pop(ev));
+    TEST_ASSERT_TRUE(ev.player == PLAYER_LEFT && ev.pressed && ev.timestampUs == 1000);
+    TEST_ASSERT_TRUE(ring.pop(ev));
+    TEST_ASSERT_TRUE(ev.player == PLAYER_LEFT && !ev.pressed && ev.timestampUs == 81000);
+    TEST_ASSERT_TRUE(ring.pop(ev));
+    TEST_ASSERT_TRUE(ring.pop(ev));
+    TEST_ASSERT_TRUE(ev.player == PLAYER_RIGHT && !ev.pressed && ev.timestampUs == 95000);
+    TEST_ASSERT_FALSE(ring.pop(ev));
+}
+
+// ======================================================
+// Edge Debouncer Tests
+// ======================================================
+// Edges are fed with the level the pin read after them, as the ISR does.
+
+static const uint32_t LOCKOUT_US = 5000;
+
+struct TraceEdge {
+    uint32_t timeUs;
+    bool pressed;   // Pin level read after the edge
+    EdgeType expected;
+};
+
+static void test_debouncer_ignores_bounce() {
+    EdgeDebouncer debouncer(LOCKOUT_US);
+    TEST_ASSERT_EQUAL(EDGE_PRESS, debouncer.onEdge(true, 1000));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.onEdge(false, 1100));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.onEdge(true, 1200));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.settle(true, 1000 + LOCKOUT_US));
+    TEST_ASSERT_EQUAL(EDGE_RELEASE, debouncer.onEdge(false, 50000));
+    TEST_ASSERT_FALSE(debouncer.isPressed());
+}
+
+// The release of a quick tap lands in the lockout window: settle() reports
+// it once the window is over, and the next press is a press again
+static void test_debouncer_recovers_edge_lost_in_lockout() {
+    EdgeDebouncer debouncer(LOCKOUT_US);
+    TEST_ASSERT_EQUAL(EDGE_PRESS, debouncer.onEdge(true, 1000));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.onEdge(false, 3000));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.settle(false, 4000));
+    TEST_ASSERT_EQUAL(EDGE_RELEASE, debouncer.settle(false, 1000 + LOCKOUT_US));
+    TEST_ASSERT_EQUAL(EDGE_PRESS, debouncer.onEdge(true, 40000));
+    TEST_ASSERT_TRUE(debouncer.isPressed());
+}
+
+// An edge that finds the pin where the state already is (its partner edge
+// was never seen) changes nothing rather than inverting the state
+static void test_debouncer_follows_level_not_edge_count() {
+    EdgeDebouncer debouncer(LOCKOUT_US);
+    TEST_ASSERT_EQUAL(EDGE_PRESS, debouncer.onEdge(true, 1000));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.onEdge(true, 20000));
+    TEST_ASSERT_TRUE(debouncer.isPressed());
+    TEST_ASSERT_EQUAL(EDGE_RELEASE, debouncer.onEdge(false, 30000));
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.onEdge(false, 40000));
+    TEST_ASSERT_FALSE(debouncer.isPressed());
+}
+
+// A recorded-style trace: two presses, each bouncing on the way down and
+// up, with one of the release's edges never reaching the ISR
+static void test_debouncer_bounce_trace() {
+    static const TraceEdge TRACE[] = {
+        {10000, true, EDGE_PRESS},
+        {10040, false, EDGE_NONE},
+        {10090, true, EDGE_NONE},
+        {10300, false, EDGE_NONE},
+        {10310, true, EDGE_NONE},
+        {90000, false, EDGE_RELEASE},
+        {90050, true, EDGE_NONE},
+        // Final falling edge at 90120 lost
+        {200000, true, EDGE_PRESS},
+        {200020, false, EDGE_NONE},
+        {200070, true, EDGE_NONE},
+        {260000, false, EDGE_RELEASE},
+    };
+    EdgeDebouncer debouncer(LOCKOUT_US);
+    uint8_t presses = 0;
+    for (const TraceEdge& edge : TRACE) {
+        EdgeType got = debouncer.onEdge(edge.pressed, edge.timeUs);
+        TEST_ASSERT_EQUAL(edge.expected, got);
+        if (got == EDGE_PRESS) presses++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, presses);
+    TEST_ASSERT_FALSE(debouncer.isPressed());
+    TEST_ASSERT_EQUAL(EDGE_NONE, debouncer.settle(false, 300000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_delivers_every_event_in_order);
+    RUN_TEST(test_ring_accounts_for_every_drop);
+    RUN_TEST(test_ring_carries_button_events);
+    RUN_TEST(test_debouncer_ignores_bounce);
+    RUN_TEST(test_debouncer_recovers_edge_lost_in_lockout);
+    RUN_TEST(test_debouncer_follows_level_not_edge_count);
+    RUN_TEST(test_debouncer_bounce_trace);
+    return UNITY_END();
+}
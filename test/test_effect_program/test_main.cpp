@@ -0,0 +1,139 @@
+#include <unity.h>
+#include "config.h"
+#include "effect_program.h"
+
+// ======================================================
+// Effect Program Tests
+// ======================================================
+// Programs are built inline as byte arrays, validated, then run by the
+// interpreter on a strip of the length under test.
+
+void setUp() {}
+void tearDown() {}
+
+static CRGB leds[MAX_NUM_LEDS];
+
+static const uint8_t TRAIL_RADIUS = 2;
+
+// Clear, then one red-to-blue glow of TRAIL_RADIUS starting halfway along
+static void buildTrail(uint8_t* code, int8_t speed, uint8_t motion) {
+    const uint8_t program[] = {
+        EFFECT_HEADER(20),
+        EFFECT_OP_FILL, 0, 0, 0,
+        EFFECT_OP_TRAIL, TRAIL_RADIUS, 100, 0, 128, (uint8_t)speed, motion, 255, 0, 0, 0, 0, 255,
+    };
+    memcpy(code, program, sizeof(program));
+}
+
+static const uint16_t TRAIL_PROGRAM_SIZE = EFFECT_HEADER_SIZE + 4 + 13;
+
+// The glow's centre: its colour is the red end of the falloff
+static uint16_t reddest(uint16_t numLeds) {
+    uint16_t best = 0;
+    for (uint16_t i = 1; i < numLeds; i++) {
+        if (leds[i].r > leds[best].r) best = i;
+    }
+    return best;
+}
+
+static uint16_t litCount(uint16_t numLeds) {
+    uint16_t lit = 0;
+    for (uint16_t i = 0; i < numLeds; i++) {
+        if (leds[i]) lit++;
+    }
+    return lit;
+}
+
+// ======================================================
+// Validation
+// ======================================================
+static void test_valid_trail_program() {
+    uint8_t code[TRAIL_PROGRAM_SIZE];
+    buildTrail(code, 3, EFFECT_MOTION_WRAP);
+    TEST_ASSERT_TRUE(effectProgramValid(code, sizeof(code)));
+
+    code[EFFECT_HEADER_SIZE + 4 + 6] = EFFECT_MOTION_WRAP + 1;  // Unknown motion
+    TEST_ASSERT_FALSE(effectProgramValid(code, sizeof(code)));
+    buildTrail(code, 3, EFFECT_MOTION_WRAP);
+    code[EFFECT_HEADER_SIZE + 4 + 1] = EFFECT_TRAIL_RADIUS_MAX + 1;
+    TEST_ASSERT_FALSE(effectProgramValid(code, sizeof(code)));
+    TEST_ASSERT_FALSE(effectProgramValid(code, sizeof(code) - 1));  // Truncated op
+}
+
+static void test_custom_palette_needs_gradient() {
+    const uint8_t without[] = {
+        EFFECT_HEADER(20),
+        EFFECT_OP_WAVE, 1, 1, 1, 1, 0,
+        EFFECT_OP_PALETTE, EFFECT_PALETTE_CUSTOM,
+    };
+    TEST_ASSERT_FALSE(effectProgramValid(without, sizeof(without)));
+
+    const uint8_t with[] = {
+        EFFECT_HEADER(20),
+        EFFECT_OP_WAVE, 1, 1, 1, 1, 0,
+        EFFECT_OP_PALETTE, EFFECT_PALETTE_CUSTOM,
+        EFFECT_OP_GRADIENT, 2, 0, 0, 0, 0, 255, 255, 255, 255,
+    };
+    TEST_ASSERT_TRUE(effectProgramValid(with, sizeof(with)));
+}
+
+// ======================================================
+// Trails
+// ======================================================
+// A wrapping trail faster than the strip is long still moves speed LEDs a
+// frame around it, and its whole glow is drawn on every frame
+static void test_fast_wrapping_trail_on_short_strip() {
+    const int8_t speeds[] = {127, -128, MIN_NUM_LEDS, MIN_NUM_LEDS + 1, -MIN_NUM_LEDS + 1, 5};
+    const uint16_t numLeds = MIN_NUM_LEDS;
+
+    for (int8_t speed : speeds) {
+        uint8_t code[TRAIL_PROGRAM_SIZE];
+        buildTrail(code, speed, EFFECT_MOTION_WRAP);
+        TEST_ASSERT_TRUE(effectProgramValid(code, sizeof(code)));
+
+        EffectAnimation effect("Fast Trail", code, sizeof(code));
+        Animation::setLength(numLeds);
+        effect.reset();
+
+        int32_t expected = ((uint32_t)numLeds * 128) >> 8;
+        for (uint16_t frame = 0; frame < 2000; frame++) {
+            effect.update(leds, numLeds);
+            TEST_ASSERT_EQUAL_UINT16(2 * TRAIL_RADIUS + 1, litCount(numLeds));
+            TEST_ASSERT_EQUAL_UINT16(expected, reddest(numLeds));
+            expected = ((expected + speed) % numLeds + numLeds) % numLeds;
+        }
+    }
+}
+
+// A bouncing trail turns back once its glow has left the strip, and comes
+// back on
+static void test_bouncing_trail_returns() {
+    const uint16_t numLeds = MIN_NUM_LEDS;
+    uint8_t code[TRAIL_PROGRAM_SIZE];
+    buildTrail(code, 4, EFFECT_MOTION_BOUNCE);
+    EffectAnimation effect("Bouncing Trail", code, sizeof(code));
+    Animation::setLength(numLeds);
+    effect.reset();
+
+    uint16_t darkFrames = 0;
+    uint16_t litFrames = 0;
+    for (uint16_t frame = 0; frame < 200; frame++) {
+        effect.update(leds, numLeds);
+        if (litCount(numLeds) == 0) {
+            darkFrames++;
+        } else {
+            litFrames++;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(0, darkFrames);
+    TEST_ASSERT_GREATER_THAN(darkFrames, litFrames);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_valid_trail_program);
+    RUN_TEST(test_custom_palette_needs_gradient);
+    RUN_TEST(test_fast_wrapping_trail_on_short_strip);
+    RUN_TEST(test_bouncing_trail_returns);
+    return UNITY_END();
+}
@@ -0,0 +1,405 @@
+#include <unity.h>
+#include <math.h>
+#include "config.h"
+#include "fixed_point.h"
+#include "hit_judge.h"
+#include "ball_field.h"
+#include "animation.h"
+
+// ======================================================
+// Fixed Point Tests
+// ======================================================
+// The Q16.16 ports against the float code they replaced. Scalar references
+// are computed in double, which holds every value used here exactly, so any
+// difference is the fixed-point code's own; the animations run frame by
+// frame beside their old float classes.
+
+void setUp() {}
+void tearDown() {}
+
+// Scaling an integer by fromRatio(num, den) gives floor(value * num / den)
+// while value * (den - 1) < 65536, which covers every use in the game
+static void test_from_ratio_scale_is_exact() {
+    for (int32_t den = 1; den <= 64; den++) {
+        for (int32_t num = 0; num <= 2 * den; num++) {
+            Q16_16 ratio = Q16_16::fromRatio(num, den);
+            for (int32_t value = 0; value * (den - 1) < 65536 && value <= 4096; value++) {
+                TEST_ASSERT_EQUAL_INT32(value * num / den, ratio.scale(value));
+            }
+        }
+    }
+}
+
+static void test_lerp_matches_float() {
+    for (int32_t a = -255; a <= 255; a += 17) {
+        for (int32_t b = -255; b <= 255; b += 15) {
+            for (int32_t raw = 0; raw <= Q16_16::ONE; raw += 257) {
+                Q16_16 t = Q16_16::fromRaw(raw);
+                int32_t expected = (int32_t)floor(a + (b - a) * (raw / 65536.0));
+                TEST_ASSERT_EQUAL_INT32(expected, Q16_16::lerp(a, b, t));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT32(10, Q16_16::lerp(10, 200, Q16_16()));
+    TEST_ASSERT_EQUAL_INT32(200, Q16_16::lerp(10, 200, Q16_16::fromInt(1)));
+}
+
+static void test_clamp_and_abs() {
+    const Q16_16 lo = Q16_16::fromRatio(1, 2);
+    const Q16_16 hi = Q16_16::fromRatio(5, 2);
+    for (int32_t raw = -4 * Q16_16::ONE; raw <= 4 * Q16_16::ONE; raw += 97) {
+        Q16_16 v = Q16_16::fromRaw(raw);
+        double expected = fmin(fmax(raw / 65536.0, 0.5), 2.5);
+        TEST_ASSERT_EQUAL_INT32((int32_t)(expected * 65536.0), v.clamp(lo, hi).raw());
+        TEST_ASSERT_EQUAL_INT32(raw < 0 ? -raw : raw, v.abs().raw());
+    }
+}
+
+// ======================================================
+// Hit Path
+// ======================================================
+// The float version the Q16.16 early-hit factor replaced
+static float earlyHitFactorFloat(int depth, uint8_t zoneSize) {
+    return (float)depth / (float)(zoneSize - 1);
+}
+
+// The speed bonus of every press position, for both players, matches the
+// float code for every zone size the game uses
+static void test_early_hit_bonus_table_matches_float() {
+    const uint16_t lengths[] = {NUM_LEDS_DEFAULT, MAX_NUM_LEDS};
+    for (uint16_t numLeds : lengths) {
+        for (uint8_t zoneSize = 2; zoneSize <= ZONE_SIZE_START; zoneSize++) {
+            for (int depth = 0; depth < zoneSize; depth++) {
+                int32_t expected = (int32_t)(earlyHitFactorFloat(depth, zoneSize) * BALL_EARLY_HIT_MAX_BONUS);
+                Q16_16 left = earlyHitFactor(PLAYER_LEFT, depth, zoneSize, numLeds);
+                Q16_16 right = earlyHitFactor(PLAYER_RIGHT, numLeds - 1 - depth, zoneSize, numLeds);
+                TEST_ASSERT_EQUAL_INT32(expected, left.scale(BALL_EARLY_HIT_MAX_BONUS));
+                TEST_ASSERT_EQUAL_INT32(expected, right.scale(BALL_EARLY_HIT_MAX_BONUS));
+            }
+            // Full bonus at the zone entry, none at the exit
+            TEST_ASSERT_EQUAL_INT32(Q16_16::ONE, earlyHitFactor(PLAYER_LEFT, zoneSize - 1, zoneSize, numLeds).raw());
+            TEST_ASSERT_EQUAL_INT32(0, earlyHitFactor(PLAYER_RIGHT, numLeds - 1, zoneSize, numLeds).raw());
+        }
+    }
+}
+
+// Return after return at one press depth, the per-LED delay follows the
+// float code's ramp, the ball crosses each LED in that delay, and every LED
+// it reaches on the way is the one the exact position says
+static void test_speed_curve_and_positions_match_float() {
+    for (uint8_t zoneSize = 2; zoneSize <= ZONE_SIZE_START; zoneSize++) {
+        for (int depth = 0; depth < zoneSize; depth++) {
+            BallField field;
+            field.add(0, +1, BALL_DELAY_START, 0);
+            double posFx = BALL_POS_ONE - 1;  // Leading edge of LED 0, as add() places it
+            uint16_t delayMs = BALL_DELAY_START;
+            uint32_t timeUs = 0;
+
+            Q16_16 factor = earlyHitFactor(PLAYER_LEFT, depth, zoneSize, NUM_LEDS_DEFAULT);
+            float factorFloat = earlyHitFactorFloat(depth, zoneSize);
+            for (uint8_t returns = 0; returns < 16; returns++) {
+                field.speedUp(0, BALL_SPEEDUP_PER_RETURN + factor.scale(BALL_EARLY_HIT_MAX_BONUS));
+                uint16_t totalSpeedup = BALL_SPEEDUP_PER_RETURN + (uint16_t)(factorFloat * BALL_EARLY_HIT_MAX_BONUS);
+                if (delayMs > BALL_DELAY_MIN + totalSpeedup) {
+                    delayMs -= totalSpeedup;
+                } else {
+                    delayMs = BALL_DELAY_MIN;
+                }
+                int64_t vel = BALL_VEL_FOR_DELAY(delayMs);
+
+                uint32_t lastChangeUs = 0;
+                int16_t lastPos = field.pos(0);
+                for (uint16_t s = 0; s < 200; s++) {
+                    timeUs += SIM_STEP_US;
+                    field.step(timeUs);
+                    posFx += vel;
+                    TEST_ASSERT_EQUAL_INT32((int32_t)floor(posFx / BALL_POS_ONE), field.pos(0));
+                    if (field.pos(0) != lastPos) {
+                        // A whole LED crossed at this speed takes the delay, give or take the step
+                        if (lastChangeUs != 0) {
+                            TEST_ASSERT_UINT32_WITHIN(SIM_STEP_US, delayMs * 1000, timeUs - lastChangeUs);
+                        }
+                        lastChangeUs = timeUs;
+                        lastPos = field.pos(0);
+                    }
+                }
+            }
+            TEST_ASSERT_EQUAL_UINT16(BALL_DELAY_MIN, delayMs);  // The curve tops out
+        }
+    }
+}
+
+// One plain return takes the float code's 4ms off the 60ms per LED the
+// serve starts at: the ball then crosses an LED in 56 steps (or 57, as the
+// velocity rounds down)
+static void test_one_return_matches_delay_ramp() {
+    BallField field;
+    field.add(0, +1, BALL_DELAY_START, 0);
+    field.speedUp(0, BALL_SPEEDUP_PER_RETURN);
+    TEST_ASSERT_TRUE(field.step(SIM_STEP_US));  // Into LED 1 from the leading edge of LED 0
+    uint32_t steps = field.stepsUntilNextLed() + 1;  // Including the step into LED 1
+    TEST_ASSERT_GREATER_OR_EQUAL(BALL_DELAY_START - BALL_SPEEDUP_PER_RETURN, steps);
+    TEST_ASSERT_LESS_OR_EQUAL(BALL_DELAY_START - BALL_SPEEDUP_PER_RETURN + 1, steps);
+}
+
+// ======================================================
+// Animation Paths
+// ======================================================
+// The float versions of Bouncing Balls and Duel Chase that the Q16.16
+// ports replaced, kept as the reference the real animations are run
+// against. Random draws come from the same stream, in the same order, as
+// the ports make them. The tuning constants are taken as Q16.16 stores
+// them (0.15 is 9830/65536, 6e-6 short): that alone moves a bounce or a
+// collision by a frame, after which the two runs go their own ways, and
+// it is the arithmetic, not the constant, that is under test.
+static const float BALL_GRAVITY = Q16_16::fromFloat(0.15f).toFloat();
+static const float DUEL_APPROACH_ACCEL = Q16_16::fromFloat(0.05f).toFloat();
+static const float DUEL_RETREAT_DECEL = Q16_16::fromFloat(0.03f).toFloat();
+
+class BouncingBallsFloat : public Animation {
+public:
+    BouncingBallsFloat() : Animation("Bouncing Balls (float)") {}
+
+    void reset() override {
+        _lastUpdate = 0;
+        for (int i = 0; i < NUM_BALLS; i++) {
+            _ballPos[i] = rng().range(5, stripLength() - 5);
+            _ballVel[i] = 0;
+            _ballGround[i] = (i % 2 == 0) ? 0 : stripLength() - 1;
+            _ballColor[i] = CHSV(i * 60 + 20, 255, 255);
+            _timeSinceKick[i] = rng().below(3000);
+        }
+    }
+
+    uint16_t frameIntervalMs() const override { return 20; }
+
+    bool update(CRGB* leds, uint16_t numLeds) override {
+        uint32_t deltaTime = timeMs() - _lastUpdate;
+        _lastUpdate = timeMs();
+
+        for (int i = 0; i < numLeds; i++) {
+            leds[i].fadeToBlackBy(80);
+        }
+
+        for (int b = 0; b < NUM_BALLS; b++) {
+            _timeSinceKick[b] += deltaTime;
+            float gravity = (_ballGround[b] == 0) ? -BALL_GRAVITY : BALL_GRAVITY;
+            _ballVel[b] += gravity;
+            _ballPos[b] += _ballVel[b];
+
+            if (_ballGround[b] == 0 && _ballPos[b] <= 0) {
+                _ballPos[b] = 0;
+                _ballVel[b] = -_ballVel[b] * DAMPING;
+                if (fabsf(_ballVel[b]) < 0.5f) _ballVel[b] = 0;
+            } else if (_ballGround[b] == numLeds - 1 && _ballPos[b] >= numLeds - 1) {
+                _ballPos[b] = numLeds - 1;
+                _ballVel[b] = -_ballVel[b] * DAMPING;
+                if (fabsf(_ballVel[b]) < 0.5f) _ballVel[b] = 0;
+            }
+
+            if (_timeSinceKick[b] > 2500 + rng().below(1500) && fabsf(_ballVel[b]) < 1.0f) {
+                float kickStrength = 3.5f + rng().below(20) / 10.0f;
+                _ballVel[b] = (_ballGround[b] == 0) ? kickStrength : -kickStrength;
+                _timeSinceKick[b] = 0;
+            }
+
+            if (_ballPos[b] < 0) _ballPos[b] = 0;
+            if (_ballPos[b] >= numLeds) _ballPos[b] = numLeds - 1;
+
+            int pos = (int)_ballPos[b];
+            leds[pos] = _ballColor[b];
+            if (pos > 0) leds[pos - 1] += _ballColor[b] % 64;
+            if (pos < numLeds - 1) leds[pos + 1] += _ballColor[b] % 64;
+        }
+        return true;
+    }
+
+private:
+    static const int NUM_BALLS = 4;
+    static constexpr float DAMPING = 0.75f;
+
+    float _ballPos[NUM_BALLS];
+    float _ballVel[NUM_BALLS];
+    int _ballGround[NUM_BALLS];
+    CRGB _ballColor[NUM_BALLS];
+    uint32_t _timeSinceKick[NUM_BALLS];
+    uint32_t _lastUpdate = 0;
+};
+
+class DuelChaseFloat : public Animation {
+public:
+    DuelChaseFloat() : Animation("Duel Chase (float)") {}
+
+    void reset() override {
+        _leftPos = 0;
+        _rightPos = stripLength() - 1;
+        _leftSpeed = 1.0f;
+        _rightSpeed = 1.0f;
+        _collisionFlash = 0;
+        _phase = PHASE_APPROACH;
+        _pauseUntil = 0;
+    }
+
+    uint16_t frameIntervalMs() const override { return 35; }
+
+    bool update(CRGB* leds, uint16_t numLeds) override {
+        fill_solid(leds, numLeds, CRGB::Black);
+
+        if (_collisionFlash > 0) {
+            fill_solid(leds, numLeds, CRGB(_collisionFlash, _collisionFlash, _collisionFlash));
+            _collisionFlash = qsub8(_collisionFlash, 40);
+            return true;
+        }
+        if (timeMs() < _pauseUntil) {
+            drawDots(leds, numLeds);
+            return true;
+        }
+
+        switch (_phase) {
+            case PHASE_APPROACH:
+                _leftSpeed = min(_leftSpeed + DUEL_APPROACH_ACCEL, 2.5f);
+                _rightSpeed = min(_rightSpeed + DUEL_APPROACH_ACCEL, 2.5f);
+                _leftPos += _leftSpeed;
+                _rightPos -= _rightSpeed;
+                if (_leftPos >= _rightPos - 2) {
+                    _collisionFlash = 255;
+                    _phase = PHASE_RETREAT;
+                    _leftSpeed = 2.0f;
+                    _rightSpeed = 2.0f;
+                }
+                break;
+
+            case PHASE_RETREAT:
+                _leftSpeed = max(_leftSpeed - DUEL_RETREAT_DECEL, 0.5f);
+                _rightSpeed = max(_rightSpeed - DUEL_RETREAT_DECEL, 0.5f);
+                _leftPos -= _leftSpeed;
+                _rightPos += _rightSpeed;
+                if (_leftPos <= 0) {
+                    _leftPos = 0;
+                    _leftSpeed = 0;
+                }
+                if (_rightPos >= numLeds - 1) {
+                    _rightPos = numLeds - 1;
+                    _rightSpeed = 0;
+                }
+                if (_leftPos <= 0 && _rightPos >= numLeds - 1) {
+                    _pauseUntil = timeMs() + 800;
+                    _phase = PHASE_APPROACH;
+                    _leftSpeed = 0.5f;
+                    _rightSpeed = 0.5f;
+                }
+                break;
+        }
+        drawDots(leds, numLeds);
+        return true;
+    }
+
+private:
+    enum Phase { PHASE_APPROACH, PHASE_RETREAT };
+
+    float _leftPos = 0;
+    float _rightPos = 0;
+    float _leftSpeed = 1.0f;
+    float _rightSpeed = 1.0f;
+    uint8_t _collisionFlash = 0;
+    Phase _phase = PHASE_APPROACH;
+    uint32_t _pauseUntil = 0;
+
+    void drawDots(CRGB* leds, uint16_t numLeds) {
+        for (int t = 0; t < 4; t++) {
+            int p = (int)_leftPos - t;
+            if (p >= 0 && p < numLeds) leds[p] = CRGB(0, 0, 255 - t * 60);
+        }
+        for (int t = 0; t < 4; t++) {
+            int p = (int)_rightPos + t;
+            if (p >= 0 && p < numLeds) leds[p] = CRGB(0, 255 - t * 60, 0);
+        }
+    }
+};
+
+// Q16.16 products round down where float ones round to nearest, so a ball
+// may bounce a frame early or late and be drawn one LED over, its glow (a
+// quarter of its colour) landing on the other side: every LED of either
+// frame must match the other frame within this many LEDs and this much
+// per channel
+static const uint16_t ANIMATION_LED_TOLERANCE = 1;
+static const uint8_t ANIMATION_COLOUR_TOLERANCE = 64;
+
+static CRGB fixedFrame[MAX_NUM_LEDS];
+static CRGB floatFrame[MAX_NUM_LEDS];
+
+static bool colourNear(const CRGB& a, const CRGB& b) {
+    return abs(a.r - b.r) <= ANIMATION_COLOUR_TOLERANCE && abs(a.g - b.g) <= ANIMATION_COLOUR_TOLERANCE &&
+           abs(a.b - b.b) <= ANIMATION_COLOUR_TOLERANCE;
+}
+
+// Every LED of a is matched by an LED of b within tolerance
+static bool framesNear(const CRGB* a, const CRGB* b, uint16_t numLeds) {
+    for (int i = 0; i < numLeds; i++) {
+        bool found = false;
+        for (int j = max(0, i - ANIMATION_LED_TOLERANCE);
+             j <= min(numLeds - 1, i + ANIMATION_LED_TOLERANCE) && !found; j++) {
+            found = colourNear(a[i], b[j]);
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// Run the registered animation and its float reference side by side on
+// the same clock and random stream, frame by frame
+static void compareWithFloat(const char* name, Animation& reference, uint16_t numLeds, uint16_t frames) {
+    AnimationManager& manager = AnimationManager::getInstance();
+    uint8_t index = 0;
+    while (index < manager.getCount() && strcmp(manager.getName(index), name) != 0) index++;
+    TEST_ASSERT_LESS_THAN(manager.getCount(), index);
+
+    Animation* port = manager.load(0, index);
+    port->seed(Rng::stream(RNG_STREAM_ANIMATION + index));
+    reference.seed(Rng::stream(RNG_STREAM_ANIMATION + index));
+    fill_solid(fixedFrame, MAX_NUM_LEDS, CRGB::Black);
+    fill_solid(floatFrame, MAX_NUM_LEDS, CRGB::Black);
+    Animation::setTime(0);
+    Animation::setLength(numLeds);
+    port->reset();
+    reference.reset();
+
+    uint32_t timeMs = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+        Animation::setTime(timeMs);
+        port->update(fixedFrame, numLeds);
+        reference.update(floatFrame, numLeds);
+        char message[64];
+        snprintf(message, sizeof(message), "%s, %u LEDs, frame %u", name, numLeds, f);
+        TEST_ASSERT_TRUE_MESSAGE(framesNear(fixedFrame, floatFrame, numLeds) &&
+                                 framesNear(floatFrame, fixedFrame, numLeds), message);
+        timeMs += port->frameIntervalMs();
+    }
+    manager.unload();
+}
+
+// About a minute of each, on the default and a long strip
+static void test_bouncing_balls_matches_float() {
+    BouncingBallsFloat reference;
+    compareWithFloat("Bouncing Balls", reference, NUM_LEDS_DEFAULT, 3000);
+    compareWithFloat("Bouncing Balls", reference, 150, 3000);
+}
+
+static void test_duel_chase_matches_float() {
+    DuelChaseFloat reference;
+    compareWithFloat("Duel Chase", reference, NUM_LEDS_DEFAULT, 2000);
+    compareWithFloat("Duel Chase", reference, 150, 2000);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_from_ratio_scale_is_exact);
+    RUN_TEST(test_lerp_matches_float);
+    RUN_TEST(test_clamp_and_abs);
+    RUN_TEST(test_early_hit_bonus_table_matches_float);
+    RUN_TEST(test_speed_curve_and_positions_match_float);
+    RUN_TEST(test_one_return_matches_delay_ramp);
+    RUN_TEST(test_bouncing_balls_matches_float);
+    RUN_TEST(test_duel_chase_matches_float);
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include "config.h"
+#include "hit_judge.h"
+#include "ball_field.h"
+
+// ======================================================
+// Hit Judgement Tests
+// ======================================================
+// Presses are judged on synthetic ball traces: the LED the ball entered
+// at each timestamp, as BallField records them, against the press time.
+
+void setUp() {}
+void tearDown() {}
+
+static const uint8_t ZONE = 10;
+static const uint16_t LEDS = NUM_LEDS_DEFAULT;
+
+// The ball runs leftwards from LED 12 to off the strip, one LED per ms
+// starting at startUs: it enters LED (12 - i) at startUs + i * 1000
+static void recordRunLeft(BallHistory& history, uint32_t startUs) {
+    for (int16_t i = 0; i <= 13; i++) {
+        history.record(startUs + i * 1000, 12 - i, -1);
+    }
+}
+
+static void test_press_before_in_and_after_zone() {
+    BallHistory history;
+    recordRunLeft(history, 1000);  // LED 9, the zone entry, at 4000
+
+    // All judged after the ball has left, as a late-processed press would be
+    HitJudgement hit = judgePress(history, PLAYER_LEFT, 3999, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(10, hit.pos);
+
+    hit = judgePress(history, PLAYER_LEFT, 4000, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(9, hit.pos);
+    TEST_ASSERT_EQUAL_INT32(Q16_16::ONE, hit.earlyFactor.raw());
+
+    hit = judgePress(history, PLAYER_LEFT, 9500, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(4, hit.pos);
+
+    hit = judgePress(history, PLAYER_LEFT, 13999, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(0, hit.pos);
+    TEST_ASSERT_EQUAL_INT32(0, hit.earlyFactor.raw());
+
+    hit = judgePress(history, PLAYER_LEFT, 14000, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(-1, hit.pos);
+
+    // The other player's zone is never hit by this trace
+    hit = judgePress(history, PLAYER_RIGHT, 8000, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+}
+
+static void test_empty_history_is_a_penalty() {
+    BallHistory history;
+    HitJudgement hit = judgePress(history, PLAYER_LEFT, 1000, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(-1, hit.pos);
+}
+
+// Only the last BALL_HISTORY_SIZE LED changes are kept; a press older than
+// all of them is judged against the oldest one kept
+static void test_press_older_than_history() {
+    BallHistory history;
+    const int16_t entries = BALL_HISTORY_SIZE + 8;
+    for (int16_t i = 0; i < entries; i++) {
+        history.record(1000 + i * 1000, entries - 1 - i, -1);
+    }
+    const int16_t oldestKept = entries - 1 - (entries - BALL_HISTORY_SIZE);  // LED 31
+
+    HitJudgement hit = judgePress(history, PLAYER_LEFT, 1500, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(oldestKept, hit.pos);
+
+    BallSample sample;
+    TEST_ASSERT_TRUE(history.sampleAt(0, sample));
+    TEST_ASSERT_EQUAL_INT16(oldestKept, sample.pos);
+
+    // The newest entries still resolve normally
+    hit = judgePress(history, PLAYER_LEFT, 1000 + (entries - 3) * 1000 + 1, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(2, hit.pos);
+}
+
+// micros() wraps every ~71 minutes; entries on either side of the wrap
+// still order by their signed distance from the press
+static void test_micros_wrap_between_entries() {
+    BallHistory history;
+    const uint32_t startUs = UINT32_MAX - 5500;  // LED 9 entered at UINT32_MAX - 2500
+    recordRunLeft(history, startUs);
+
+    HitJudgement hit = judgePress(history, PLAYER_LEFT, UINT32_MAX - 2501, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(10, hit.pos);
+
+    hit = judgePress(history, PLAYER_LEFT, UINT32_MAX, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(7, hit.pos);
+
+    // LED 6 was entered at 0xFFFFFFFF + 500, i.e. 499 after the wrap
+    hit = judgePress(history, PLAYER_LEFT, 498, ZONE, LEDS);
+    TEST_ASSERT_EQUAL_INT16(7, hit.pos);
+    hit = judgePress(history, PLAYER_LEFT, 499, ZONE, LEDS);
+    TEST_ASSERT_EQUAL_INT16(6, hit.pos);
+
+    hit = judgePress(history, PLAYER_LEFT, 7498, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_RETURN, hit.outcome);
+    TEST_ASSERT_EQUAL_INT16(0, hit.pos);
+    hit = judgePress(history, PLAYER_LEFT, 7499, ZONE, LEDS);
+    TEST_ASSERT_EQUAL(HIT_PENALTY, hit.outcome);
+}
+
+// ======================================================
+// Ball Field Judgement
+// ======================================================
+// A ball heading into the zone is returned before one already leaving it
+static void test_two_balls_prefer_incoming() {
+    BallField field;
+    field.add(3, +1, BALL_DELAY_START, 1000);  // Already returned, leaving
+    field.add(6, -1, BALL_DELAY_START, 1000);  // Coming in
+
+    HitJudgement hit;
+    TEST_ASSERT_EQUAL_INT8(1, field.judge(PLAYER_LEFT, 2000, ZONE, LEDS, hit));
+    TEST_ASSERT_EQUAL_INT16(6, hit.pos);
+}
+
+// Of two incoming balls, the one closest to leaving the zone is returned
+static void test_two_balls_prefer_deepest() {
+    BallField field;
+    field.add(2, -1, BALL_DELAY_START, 1000);
+    field.add(7, -1, BALL_DELAY_START, 1000);
+
+    HitJudgement hit;
+    TEST_ASSERT_EQUAL_INT8(0, field.judge(PLAYER_LEFT, 2000, ZONE, LEDS, hit));
+    TEST_ASSERT_EQUAL_INT16(2, hit.pos);
+
+    // And mirrored on the right
+    field.clear();
+    field.add(LEDS - 8, +1, BALL_DELAY_START, 1000);
+    field.add(LEDS - 2, +1, BALL_DELAY_START, 1000);
+    TEST_ASSERT_EQUAL_INT8(1, field.judge(PLAYER_RIGHT, 2000, ZONE, LEDS, hit));
+    TEST_ASSERT_EQUAL_INT16(LEDS - 2, hit.pos);
+}
+
+// Balls are judged where they were at the press, not where they are now
+static void test_field_judges_at_press_time() {
+    BallField field;
+    field.add(1, -1, 1, 1000);  // One LED per 1ms step
+    field.add(20, -1, 1, 1000);
+    field.step(2000);                       // LED 0, and 19
+    field.step(3000);                       // Off the strip, and 18
+
+    HitJudgement hit;
+    TEST_ASSERT_EQUAL_INT8(0, field.judge(PLAYER_LEFT, 2500, ZONE, LEDS, hit));
+    TEST_ASSERT_EQUAL_INT16(0, hit.pos);
+    TEST_ASSERT_EQUAL_INT8(-1, field.judge(PLAYER_LEFT, 3000, ZONE, LEDS, hit));
+    TEST_ASSERT_EQUAL_INT8(-1, field.judge(PLAYER_RIGHT, 2500, ZONE, LEDS, hit));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_press_before_in_and_after_zone);
+    RUN_TEST(test_empty_history_is_a_penalty);
+    RUN_TEST(test_press_older_than_history);
+    RUN_TEST(test_micros_wrap_between_entries);
+    RUN_TEST(test_two_balls_prefer_incoming);
+    RUN_TEST(test_two_balls_prefer_deepest);
+    RUN_TEST(test_field_judges_at_press_time);
+    return UNITY_END();
+}
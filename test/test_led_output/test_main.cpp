@@ -0,0 +1,169 @@
+#include <unity.h>
+#include "sim.h"
+#include "led_output.h"
+
+// ======================================================
+// LED Output Timing Tests
+// ======================================================
+// The output and game tasks run on the simulation kernel, at their
+// firmware priorities, against the modelled transmitter. The game task
+// submits frames and samples the timing the output task publishes; the
+// tests check the timestamps once the run is over. The kernel runs once
+// per process, so every test reads the same run.
+
+void setUp() {}
+void tearDown() {}
+
+static const uint16_t LEDS = 150;
+static const uint8_t BURST = 3;  // Frames submitted while one is on the wire
+
+static CRGB leds[MAX_NUM_LEDS];
+
+struct SubmitTrace {
+    uint32_t beforeUs;  // Just before show()
+    uint32_t afterUs;   // Just after it returned
+};
+
+static SubmitTrace submits[3 + BURST];
+static LedFrameTiming timings[8];  // Each distinct timing the game task saw
+static uint8_t timingCount = 0;
+static uint32_t frameCount = 0;
+static uint32_t wireErrors = 0;
+static bool ran = false;
+
+static void submitFrame(uint8_t n) {
+    fill_solid(leds, LEDS, CRGB(n * 40, 255 - n * 40, n));
+    submits[n].beforeUs = micros();
+    LedOutput::show();
+    submits[n].afterUs = micros();
+}
+
+// Sample lastTiming() once per tick until idleMs ticks pass with nothing new
+static void collectTimings(uint8_t idleMs) {
+    for (uint8_t idle = 0; idle < idleMs; idle++) {
+        LedFrameTiming t = LedOutput::lastTiming();
+        if (t.completeUs != 0 && (timingCount == 0 || t.submitUs != timings[timingCount - 1].submitUs) &&
+            timingCount < sizeof(timings) / sizeof(timings[0])) {
+            timings[timingCount++] = t;
+            idle = 0;
+        }
+        vTaskDelay(1);
+    }
+}
+
+static void outputTask(void*) {
+    LedOutput::begin();
+    for (;;) {
+        LedOutput::service();
+    }
+}
+
+static void gameTask(void*) {
+    vTaskDelay(2);
+
+    // Frames 0 and 1 back to back, the second rendered while the first is
+    // on the wire (render cost modelled as 2ms of CPU)
+    submitFrame(0);
+    delayMicroseconds(2000);
+    submitFrame(1);
+    collectTimings(20);
+
+    // Frame 2 goes out, then a burst lands during its transmission: only
+    // the newest of the burst is sent
+    submitFrame(2);
+    delayMicroseconds(500);
+    for (uint8_t b = 0; b < BURST; b++) {
+        submitFrame(3 + b);
+        delayMicroseconds(200);
+    }
+    collectTimings(20);
+
+    frameCount = LedOutput::frameCount();
+    wireErrors = LedOutput::wireErrors();
+    sim::stop();
+    vTaskDelay(1);  // Parks the task for good
+}
+
+static void runOnce() {
+    if (ran) return;
+    ran = true;
+    LedOutput::init(leds, LEDS);
+    LedOutput::setBrightness(BRIGHTNESS);
+    xTaskCreatePinnedToCore(outputTask, "Out", 4096, NULL, 3, NULL, 0);
+    xTaskCreatePinnedToCore(gameTask, "Game", 8192, NULL, 1, NULL, 1);
+    sim::run(1000000);
+}
+
+// The timing published for submitted frame n, or nullptr if it was not sent
+static const LedFrameTiming* timingFor(uint8_t n) {
+    for (uint8_t i = 0; i < timingCount; i++) {
+        if ((int32_t)(timings[i].submitUs - submits[n].beforeUs) > 0 &&
+            (int32_t)(submits[n].afterUs - timings[i].submitUs) > 0) {
+            return &timings[i];
+        }
+    }
+    return nullptr;
+}
+
+// show() hands the frame over and returns well before it is on the strip
+static void test_submit_returns_before_wire_time() {
+    runOnce();
+    for (uint8_t n = 0; n < 3; n++) {
+        const LedFrameTiming* t = timingFor(n);
+        TEST_ASSERT_NOT_NULL(t);
+        TEST_ASSERT_LESS_THAN(LedOutput::wireTimeUs(LEDS) / 4, submits[n].afterUs - submits[n].beforeUs);
+        TEST_ASSERT_GREATER_THAN(submits[n].afterUs, t->completeUs);
+    }
+}
+
+// Each frame takes its full wire time from the start of transmission (plus
+// the odd microsecond: every clock read costs 1us on the simulation)
+static void test_complete_follows_wire_time() {
+    runOnce();
+    for (uint8_t n = 0; n < 3; n++) {
+        const LedFrameTiming* t = timingFor(n);
+        TEST_ASSERT_NOT_NULL(t);
+        TEST_ASSERT_GREATER_OR_EQUAL(LedOutput::wireTimeUs(LEDS), t->completeUs - t->startUs);
+        TEST_ASSERT_LESS_OR_EQUAL(LedOutput::wireTimeUs(LEDS) + 10, t->completeUs - t->startUs);
+        TEST_ASSERT_TRUE((int32_t)(t->startUs - t->submitUs) >= 0);
+    }
+}
+
+// Frame 1 was rendered and submitted while frame 0 was still being sent,
+// and went out as soon as frame 0 had latched: no more than one tick of the
+// output task's completion polling in between
+static void test_render_overlaps_transmit() {
+    runOnce();
+    const LedFrameTiming* first = timingFor(0);
+    const LedFrameTiming* second = timingFor(1);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE((int32_t)(submits[1].beforeUs - first->startUs) > 0);
+    TEST_ASSERT_TRUE((int32_t)(first->completeUs - submits[1].afterUs) > 0);
+    TEST_ASSERT_TRUE((int32_t)(second->startUs - first->completeUs) >= 0);
+    TEST_ASSERT_LESS_OR_EQUAL(1000 + 50, second->startUs - first->completeUs);
+}
+
+// Frames replaced before the output task reached them are counted as
+// dropped; the newest one is sent
+static void test_burst_sends_newest_and_counts_drops() {
+    runOnce();
+    TEST_ASSERT_EQUAL_UINT32(3 + BURST, frameCount);
+    for (uint8_t b = 0; b < BURST - 1; b++) {
+        TEST_ASSERT_NULL(timingFor(3 + b));
+    }
+    const LedFrameTiming* newest = timingFor(3 + BURST - 1);
+    TEST_ASSERT_NOT_NULL(newest);
+    TEST_ASSERT_EQUAL_UINT32(BURST - 1, newest->dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, timingFor(2)->dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, wireErrors);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_returns_before_wire_time);
+    RUN_TEST(test_complete_follows_wire_time);
+    RUN_TEST(test_render_overlaps_transmit);
+    RUN_TEST(test_burst_sends_newest_and_counts_drops);
+    return UNITY_END();
+}
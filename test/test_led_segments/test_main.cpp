@@ -0,0 +1,188 @@
+#include <unity.h>
+#include "config.h"
+#include "frame_kernels.h"
+#include "led_segment_map.h"
+#include "ws2812_codec.h"
+
+// ======================================================
+// Segment Split & Bitstream Tests
+// ======================================================
+// Each test strip is split into segments, every segment is encoded to
+// WS2812 symbols and decoded again as the strip would read it, and the
+// decoded segments are put back together and compared with the source
+// frame. pio test -e native covers one segment; native_seg3, native_seg4
+// and native_seg8 build the same suite with LED_SEGMENT_COUNT 3, 4 and 8.
+
+void setUp() {}
+void tearDown() {}
+
+// Lengths that leave a remainder for 3, 4 and 8 segments, and the extremes
+static const uint16_t LENGTHS[] = {MIN_NUM_LEDS, 23, NUM_LEDS_DEFAULT, 57, 150, 299, 599, MAX_NUM_LEDS};
+
+static CRGB frame[MAX_NUM_LEDS];
+static uint8_t wire[LED_SEGMENT_COUNT][LED_SEGMENT_MAX_LEDS * 3];
+static uint32_t symbols[LED_SEGMENT_MAX_LEDS * 3 * 8];
+static uint8_t decoded[LED_SEGMENT_COUNT][LED_SEGMENT_MAX_LEDS * 3 + 1];  // Per pin, plus a guard byte
+
+static void fillFrame(uint16_t numLeds, uint8_t seed) {
+    for (uint16_t i = 0; i < numLeds; i++) {
+        frame[i] = CRGB(i * 7 + seed, 255 - i * 3, (i * i + seed) >> 2);
+    }
+}
+
+// Wire bytes as the strip receives them: GRB order, scaled by brightness
+static void expectedBytes(uint16_t i, uint8_t brightness, uint8_t out[3]) {
+    out[0] = brightness == 255 ? frame[i].g : scale8_video(frame[i].g, brightness);
+    out[1] = brightness == 255 ? frame[i].r : scale8_video(frame[i].r, brightness);
+    out[2] = brightness == 255 ? frame[i].b : scale8_video(frame[i].b, brightness);
+}
+
+// ======================================================
+// Segment Layout
+// ======================================================
+static void test_layout_covers_strip_evenly() {
+    LedSegmentMap map;
+    for (uint16_t numLeds : LENGTHS) {
+        map.layout(numLeds);
+        TEST_ASSERT_EQUAL_UINT16(numLeds, map.numLeds());
+        TEST_ASSERT_EQUAL_UINT8(LED_SEGMENT_COUNT, map.count());
+
+        uint16_t next = 0;
+        for (uint8_t s = 0; s < map.count(); s++) {
+            TEST_ASSERT_EQUAL_UINT16(next, map[s].first);
+            TEST_ASSERT_EQUAL_UINT8(LedSegmentMap::pin(s), map[s].pin);
+            TEST_ASSERT_LESS_OR_EQUAL(LED_SEGMENT_MAX_LEDS, map[s].count);
+            // Earlier segments take the remainder, one LED each
+            uint16_t expected = numLeds / LED_SEGMENT_COUNT + (s < numLeds % LED_SEGMENT_COUNT ? 1 : 0);
+            TEST_ASSERT_EQUAL_UINT16(expected, map[s].count);
+            next += map[s].count;
+        }
+        TEST_ASSERT_EQUAL_UINT16(numLeds, next);
+    }
+}
+
+static void test_locate_inverts_layout() {
+    LedSegmentMap map;
+    for (uint16_t numLeds : LENGTHS) {
+        map.layout(numLeds);
+        for (uint16_t i = 0; i < numLeds; i++) {
+            uint8_t segment = 0xFF;
+            uint16_t offset = 0xFFFF;
+            TEST_ASSERT_TRUE(map.locate(i, segment, offset));
+            TEST_ASSERT_LESS_THAN(map.count(), segment);
+            TEST_ASSERT_LESS_THAN(map[segment].count, offset);
+            TEST_ASSERT_EQUAL_UINT16(i, map[segment].first + offset);
+        }
+        uint8_t segment;
+        uint16_t offset;
+        TEST_ASSERT_FALSE(map.locate(numLeds, segment, offset));
+        TEST_ASSERT_FALSE(map.locate(MAX_NUM_LEDS, segment, offset));
+    }
+}
+
+// ======================================================
+// Encode / Decode Round Trip
+// ======================================================
+// Send frame through every segment's bitstream, decoding each pin's stream
+// as its strip would read it
+static void sendAndDecode(const LedSegmentMap& map, uint8_t brightness) {
+    for (uint8_t s = 0; s < map.count(); s++) {
+        const LedSegment& segment = map[s];
+        size_t len = segment.count * 3;
+        FrameKernels::encode(wire[s], frame + segment.first, segment.count, brightness);
+
+        size_t count = 0;
+        size_t used = Ws2812Codec::encode(wire[s], len, symbols, sizeof(symbols) / sizeof(symbols[0]), &count);
+        TEST_ASSERT_EQUAL_UINT32(len, used);
+        TEST_ASSERT_EQUAL_UINT32(len * 8, count);
+        TEST_ASSERT_EQUAL_INT32((int32_t)len, Ws2812Codec::decode(symbols, count, decoded[s]));
+        // Nothing decoded past the segment
+        TEST_ASSERT_EQUAL_UINT8(0xA5, decoded[s][len]);
+    }
+}
+
+// Every LED of the logical strip, found through locate(), decodes to the
+// source frame's colour
+static void test_round_trip_rebuilds_source_frame() {
+    LedSegmentMap map;
+    const uint8_t brightnesses[] = {255, BRIGHTNESS, 1};
+    for (uint16_t numLeds : LENGTHS) {
+        map.layout(numLeds);
+        for (uint8_t brightness : brightnesses) {
+            fillFrame(numLeds, numLeds + brightness);
+            memset(decoded, 0xA5, sizeof(decoded));
+            sendAndDecode(map, brightness);
+
+            for (uint16_t i = 0; i < numLeds; i++) {
+                uint8_t segment;
+                uint16_t offset;
+                TEST_ASSERT_TRUE(map.locate(i, segment, offset));
+                uint8_t expected[3];
+                expectedBytes(i, brightness, expected);
+                TEST_ASSERT_EQUAL_MEMORY(expected, decoded[segment] + offset * 3, 3);
+            }
+        }
+    }
+}
+
+// The RMT translator asks for a few symbols at a time; the pieces must
+// join into the same stream as one call, and never split a byte
+static void test_chunked_encode_matches_whole() {
+    static uint32_t whole[150 * 3 * 8];
+    static uint32_t pieces[150 * 3 * 8];
+    const uint16_t numLeds = min(150, LED_SEGMENT_MAX_LEDS);
+    const size_t len = numLeds * 3;
+    fillFrame(numLeds, 3);
+    FrameKernels::encode(wire[0], frame, numLeds, 255);
+
+    size_t wholeCount = 0;
+    Ws2812Codec::encode(wire[0], len, whole, sizeof(whole) / sizeof(whole[0]), &wholeCount);
+
+    const size_t chunks[] = {8, 13, 64, 100};
+    for (size_t chunk : chunks) {
+        size_t done = 0;
+        size_t count = 0;
+        while (done < len) {
+            size_t n = 0;
+            size_t used = Ws2812Codec::encode(wire[0] + done, len - done, pieces + count, chunk, &n);
+            TEST_ASSERT_EQUAL_UINT32(min(chunk / 8, len - done), used);
+            TEST_ASSERT_EQUAL_UINT32(used * 8, n);
+            done += used;
+            count += n;
+        }
+        TEST_ASSERT_EQUAL_UINT32(wholeCount, count);
+        TEST_ASSERT_EQUAL_MEMORY(whole, pieces, count * sizeof(uint32_t));
+    }
+}
+
+// Symbols outside the datasheet tolerance, inverted levels and a stream
+// ending mid-byte are all rejected
+static void test_decode_rejects_bad_streams() {
+    uint32_t stream[8];
+    uint8_t byte = 0;
+    for (uint8_t i = 0; i < 8; i++) stream[i] = (i % 2) ? WS2812_BIT1 : WS2812_BIT0;
+    TEST_ASSERT_EQUAL_INT32(1, Ws2812Codec::decode(stream, 8, &byte));
+    TEST_ASSERT_EQUAL_UINT8(0x55, byte);
+
+    TEST_ASSERT_EQUAL_INT32(-1, Ws2812Codec::decode(stream, 7, &byte));
+
+    stream[3] = WS2812_SYMBOL(WS2812_T1H + WS2812_TOL, WS2812_T1L - WS2812_TOL);
+    TEST_ASSERT_EQUAL_INT32(1, Ws2812Codec::decode(stream, 8, &byte));
+    stream[3] = WS2812_SYMBOL(WS2812_T1H + WS2812_TOL + 1, WS2812_T1L);
+    TEST_ASSERT_EQUAL_INT32(-1, Ws2812Codec::decode(stream, 8, &byte));
+
+    stream[3] = WS2812_BIT1 & ~(1UL << 15);  // High pulse sent low
+    TEST_ASSERT_EQUAL_INT32(-1, Ws2812Codec::decode(stream, 8, &byte));
+    stream[3] = WS2812_BIT1 | (1UL << 31);   // Low pulse sent high
+    TEST_ASSERT_EQUAL_INT32(-1, Ws2812Codec::decode(stream, 8, &byte));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_layout_covers_strip_evenly);
+    RUN_TEST(test_locate_inverts_layout);
+    RUN_TEST(test_round_trip_rebuilds_source_frame);
+    RUN_TEST(test_chunked_encode_matches_whole);
+    RUN_TEST(test_decode_rejects_bad_streams);
+    return UNITY_END();
+}
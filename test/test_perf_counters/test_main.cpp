@@ -0,0 +1,140 @@
+#include <unity.h>
+#include "perf_counters.h"
+
+// ======================================================
+// Performance Counter Tests
+// ======================================================
+// Run with the counters compiled in (pio test -e native) and compiled out
+// (pio test -e native_no_perf).
+
+#if PERF_COUNTERS
+
+#include <thread>
+
+void setUp() { PerfCounters::reset(); }
+void tearDown() {}
+
+static uint32_t histogramTotal(PerfHistogram histogram) {
+    uint32_t n = 0;
+    for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+        n += PerfCounters::bucket(histogram, b);
+    }
+    return n;
+}
+
+// Bucket 0 is 0us, bucket b is [2^(b-1), 2^b) and the last one takes the rest
+static void test_bucket_boundaries() {
+    TEST_ASSERT_EQUAL_UINT8(0, PerfCounters::bucketFor(0));
+    TEST_ASSERT_EQUAL_UINT8(1, PerfCounters::bucketFor(1));
+    for (uint8_t b = 1; b < PERF_BUCKETS - 1; b++) {
+        uint32_t lower = 1UL << (b - 1);
+        TEST_ASSERT_EQUAL_UINT8(b, PerfCounters::bucketFor(lower));
+        TEST_ASSERT_EQUAL_UINT8(b, PerfCounters::bucketFor(2 * lower - 1));
+        TEST_ASSERT_EQUAL_UINT8(b + 1, PerfCounters::bucketFor(2 * lower));
+    }
+}
+
+static void test_bucket_overflow() {
+    TEST_ASSERT_EQUAL_UINT8(PERF_BUCKETS - 1, PerfCounters::bucketFor(1UL << (PERF_BUCKETS - 2)));
+    TEST_ASSERT_EQUAL_UINT8(PERF_BUCKETS - 1, PerfCounters::bucketFor(1UL << (PERF_BUCKETS - 1)));
+    TEST_ASSERT_EQUAL_UINT8(PERF_BUCKETS - 1, PerfCounters::bucketFor(1UL << 31));
+    TEST_ASSERT_EQUAL_UINT8(PERF_BUCKETS - 1, PerfCounters::bucketFor(UINT32_MAX));
+}
+
+static void test_sample_fills_bucket_and_tracks_max() {
+    PerfCounters::sample(PERF_SHOW_US, 5);
+    PerfCounters::sample(PERF_SHOW_US, 700);
+    PerfCounters::sample(PERF_SHOW_US, 6);
+    PerfCounters::sample(PERF_SHOW_US, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(2, PerfCounters::bucket(PERF_SHOW_US, PerfCounters::bucketFor(5)));
+    TEST_ASSERT_EQUAL_UINT32(1, PerfCounters::bucket(PERF_SHOW_US, PerfCounters::bucketFor(700)));
+    TEST_ASSERT_EQUAL_UINT32(1, PerfCounters::bucket(PERF_SHOW_US, 0));
+    TEST_ASSERT_EQUAL_UINT32(4, histogramTotal(PERF_SHOW_US));
+    TEST_ASSERT_EQUAL_UINT32(700, PerfCounters::maxUs(PERF_SHOW_US));
+
+    // Other histograms are untouched
+    TEST_ASSERT_EQUAL_UINT32(0, histogramTotal(PERF_GAME_LOOP_US));
+    TEST_ASSERT_EQUAL_UINT32(0, PerfCounters::maxUs(PERF_GAME_LOOP_US));
+}
+
+static void test_overflow_sample_keeps_exact_max() {
+    PerfCounters::sample(PERF_TRANSMIT_US, 1000000);
+    TEST_ASSERT_EQUAL_UINT32(1, PerfCounters::bucket(PERF_TRANSMIT_US, PERF_BUCKETS - 1));
+    TEST_ASSERT_EQUAL_UINT32(1000000, PerfCounters::maxUs(PERF_TRANSMIT_US));
+}
+
+static void test_reset_clears_everything() {
+    PerfCounters::count(PERF_INPUT_EDGES);
+    PerfCounters::count(PERF_CATCHUP_DROPS);
+    PerfCounters::sample(PERF_GAME_LOOP_US, 123);
+    PerfCounters::sample(PERF_TRANSMIT_US, 1UL << 20);
+
+    PerfCounters::reset();
+    for (uint8_t c = 0; c < PERF_COUNTER_COUNT; c++) {
+        TEST_ASSERT_EQUAL_UINT32(0, PerfCounters::counter((PerfCounter)c));
+    }
+    for (uint8_t h = 0; h < PERF_HISTOGRAM_COUNT; h++) {
+        TEST_ASSERT_EQUAL_UINT32(0, histogramTotal((PerfHistogram)h));
+        TEST_ASSERT_EQUAL_UINT32(0, PerfCounters::maxUs((PerfHistogram)h));
+    }
+}
+
+// Increments from several threads at once all land, and the max is the
+// largest sample any of them took
+static void test_concurrent_updates() {
+    const uint32_t PER_THREAD = 20000;
+    std::thread workers[4];
+    for (uint8_t t = 0; t < 4; t++) {
+        workers[t] = std::thread([t] {
+            for (uint32_t i = 0; i < PER_THREAD; i++) {
+                PerfCounters::count(PERF_INPUT_EDGES);
+                PerfCounters::sample(PERF_GAME_LOOP_US, t * PER_THREAD + i);
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+
+    TEST_ASSERT_EQUAL_UINT32(4 * PER_THREAD, PerfCounters::counter(PERF_INPUT_EDGES));
+    TEST_ASSERT_EQUAL_UINT32(4 * PER_THREAD, histogramTotal(PERF_GAME_LOOP_US));
+    TEST_ASSERT_EQUAL_UINT32(4 * PER_THREAD - 1, PerfCounters::maxUs(PERF_GAME_LOOP_US));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_boundaries);
+    RUN_TEST(test_bucket_overflow);
+    RUN_TEST(test_sample_fills_bucket_and_tracks_max);
+    RUN_TEST(test_overflow_sample_keeps_exact_max);
+    RUN_TEST(test_reset_clears_everything);
+    RUN_TEST(test_concurrent_updates);
+    return UNITY_END();
+}
+
+#else
+
+#include <type_traits>
+
+void setUp() {}
+void tearDown() {}
+
+// Compiled out, the instrumentation points are empty inlines with no state
+static_assert(std::is_empty<PerfCounters>::value, "PerfCounters keeps state with PERF_COUNTERS off");
+static_assert(std::is_empty<PerfTimer>::value, "PerfTimer keeps state with PERF_COUNTERS off");
+
+static void test_calls_compile_to_nothing() {
+    PerfCounters::count(PERF_INPUT_DROPS);
+    PerfCounters::sample(PERF_SHOW_US, 42);
+    PerfCounters::watchTask(nullptr, "test", 0);
+    PerfTimer timer(PERF_GAME_LOOP_US);
+    timer.stop();
+    TEST_ASSERT_EQUAL(1, sizeof(timer));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_calls_compile_to_nothing);
+    return UNITY_END();
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include <unity.h>
+#include "rng.h"
+
+// ======================================================
+// Random Number Generator Tests
+// ======================================================
+// Replays depend on a seed giving the same numbers on every build, so the
+// sequences are checked against fixed values, not just for variety.
+
+void setUp() { Rng::setMasterSeed(0x12345678u); }
+void tearDown() {}
+
+static const uint16_t DRAWS = 10000;
+
+// Marsaglia's xorshift32 (13, 17, 5) from seed 1
+static void test_fixed_seed_gives_fixed_sequence() {
+    const uint32_t expected[] = {270369u, 67634689u, 2647435461u, 307599695u, 2398689233u};
+    Rng rng(1);
+    for (uint32_t value : expected) {
+        TEST_ASSERT_EQUAL_UINT32(value, rng.next());
+    }
+
+    Rng again(1);
+    again.next();
+    rng.reseed(1);
+    TEST_ASSERT_EQUAL_UINT32(270369u, rng.next());
+    TEST_ASSERT_EQUAL_UINT32(again.next(), rng.next());
+}
+
+// Zero would stick at zero; it is replaced with a fixed non-zero seed
+static void test_zero_seed_is_replaced() {
+    Rng zero(0);
+    Rng replacement(0x9E3779B9u);
+    for (uint8_t i = 0; i < 8; i++) {
+        uint32_t value = zero.next();
+        TEST_ASSERT_NOT_EQUAL(0, value);
+        TEST_ASSERT_EQUAL_UINT32(replacement.next(), value);
+    }
+}
+
+// ======================================================
+// Streams
+// ======================================================
+static void test_stream_repeats_for_same_id() {
+    Rng a = Rng::stream(RNG_STREAM_GAME);
+    Rng b = Rng::stream(RNG_STREAM_GAME);
+    for (uint16_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_UINT32(a.next(), b.next());
+    }
+}
+
+// Neighbouring ids, as the animations use, start unrelated streams
+static void test_stream_differs_per_id() {
+    const uint32_t ids[] = {RNG_STREAM_GAME, RNG_STREAM_BUTTON_LED, RNG_STREAM_ANIMATION,
+                            RNG_STREAM_ANIMATION + 1, RNG_STREAM_ANIMATION + 2};
+    const uint8_t count = sizeof(ids) / sizeof(ids[0]);
+    uint32_t first[count];
+    for (uint8_t i = 0; i < count; i++) {
+        Rng rng = Rng::stream(ids[i]);
+        first[i] = rng.next();
+        for (uint8_t j = 0; j < i; j++) {
+            TEST_ASSERT_NOT_EQUAL(first[j], first[i]);
+        }
+    }
+}
+
+// The master seed changes every stream, and setting it back restores them
+static void test_master_seed_selects_streams() {
+    uint32_t before = Rng::stream(RNG_STREAM_GAME).next();
+    Rng::setMasterSeed(0x12345679u);
+    TEST_ASSERT_NOT_EQUAL(before, Rng::stream(RNG_STREAM_GAME).next());
+    Rng::setMasterSeed(0x12345678u);
+    TEST_ASSERT_EQUAL_UINT32(before, Rng::stream(RNG_STREAM_GAME).next());
+}
+
+// ======================================================
+// Ranges
+// ======================================================
+static void test_below_stays_in_bounds() {
+    Rng rng(42);
+    const uint32_t bounds[] = {2, 3, 7, 100, 1000, 0x80000000u, 0xFFFFFFFFu};
+    for (uint32_t n : bounds) {
+        for (uint16_t i = 0; i < DRAWS; i++) {
+            TEST_ASSERT_LESS_THAN(n, rng.below(n));
+        }
+    }
+    for (uint16_t i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, rng.below(1));
+        TEST_ASSERT_EQUAL_UINT32(0, rng.below(0));
+    }
+}
+
+// Every value of a small range comes up, at roughly its share
+static void test_below_covers_range() {
+    Rng rng(7);
+    uint16_t hits[10] = {};
+    for (uint16_t i = 0; i < DRAWS; i++) {
+        hits[rng.below(10)]++;
+    }
+    for (uint16_t h : hits) {
+        TEST_ASSERT_UINT32_WITHIN(DRAWS / 10 / 5, DRAWS / 10, h);
+    }
+}
+
+static void test_range_stays_in_bounds() {
+    Rng rng(99);
+    for (uint16_t i = 0; i < DRAWS; i++) {
+        int32_t v = rng.range(-5, 5);
+        TEST_ASSERT_TRUE(v >= -5 && v < 5);
+        v = rng.range(5, 50);
+        TEST_ASSERT_TRUE(v >= 5 && v < 50);
+    }
+
+    // The full span of int32_t: hi - lo wraps to 0xFFFFFFFF, not negative
+    bool sawNegative = false;
+    bool sawPositive = false;
+    for (uint16_t i = 0; i < DRAWS; i++) {
+        int32_t v = rng.range(INT32_MIN, INT32_MAX);
+        TEST_ASSERT_TRUE(v < INT32_MAX);
+        if (v < 0) sawNegative = true;
+        if (v > 0) sawPositive = true;
+    }
+    TEST_ASSERT_TRUE(sawNegative && sawPositive);
+
+    // Empty and single-value ranges give lo
+    TEST_ASSERT_EQUAL_INT32(3, rng.range(3, 4));
+    TEST_ASSERT_EQUAL_INT32(3, rng.range(3, 3));
+    TEST_ASSERT_EQUAL_INT32(3, rng.range(3, -3));
+}
+
+static void test_chance_extremes() {
+    Rng rng(5);
+    uint16_t hits = 0;
+    for (uint16_t i = 0; i < DRAWS; i++) {
+        TEST_ASSERT_FALSE(rng.chance(0));
+        TEST_ASSERT_TRUE(rng.chance(100));
+        TEST_ASSERT_TRUE(rng.chance(255));
+        if (rng.chance(25)) hits++;
+    }
+    TEST_ASSERT_UINT32_WITHIN(DRAWS / 25, DRAWS / 4, hits);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_seed_gives_fixed_sequence);
+    RUN_TEST(test_zero_seed_is_replaced);
+    RUN_TEST(test_stream_repeats_for_same_id);
+    RUN_TEST(test_stream_differs_per_id);
+    RUN_TEST(test_master_seed_selects_streams);
+    RUN_TEST(test_below_stays_in_bounds);
+    RUN_TEST(test_below_covers_range);
+    RUN_TEST(test_range_stays_in_bounds);
+    RUN_TEST(test_chance_extremes);
+    return UNITY_END();
+}